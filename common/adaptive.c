@@ -0,0 +1,117 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: grows the buffer while both
+*          sides keep blocking on each other
+*          and shrinks it while most of it
+*          sits unused
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <string.h>
+
+#include "adaptive.h"
+#include "livestats.h"
+
+/****************************************
+* NAME: adaptInit
+* IMPORT: controller, starting capacity,
+*         bounds
+* EXPORT: none
+* PURPOSE: starts the first window
+****************************************/
+void adaptInit(Adaptive* adaptive, int capacity, int low, int high)
+{
+    memset(adaptive, 0, sizeof(Adaptive));
+    adaptive->low = low;
+    adaptive->high = high;
+    adaptive->capacity = capacity;
+    adaptive->startNs = statsNow();
+    adaptive->windowNs = adaptive->startNs;
+    adaptive->historyCapacity[0] = capacity;
+    adaptive->changes = 1;
+}
+
+/****************************************
+* NAME: adaptProducer / adaptConsumer
+* IMPORT: controller, time blocked
+* EXPORT: none
+* PURPOSE: LiftR waiting for a free slot,
+*          a lift waiting for a request
+*          (caller holds the sim lock)
+****************************************/
+void adaptProducer(Adaptive* adaptive, long ns)
+{
+    adaptive->producerNs += ns;
+    adaptive->producerTotalNs += ns;
+}
+
+void adaptConsumer(Adaptive* adaptive, long ns)
+{
+    adaptive->consumerNs += ns;
+    adaptive->consumerTotalNs += ns;
+}
+
+/****************************************
+* NAME: adaptCheck
+* IMPORT: controller, requests queued,
+*         number of lifts
+* EXPORT: capacity the buffer should have
+* PURPOSE: called by LiftR after each
+*          enqueue, decides once a window
+*          has passed
+****************************************/
+int adaptCheck(Adaptive* adaptive, int queued, int consumers)
+{
+    long now = statsNow(), window = now - adaptive->windowNs;
+    int capacity = adaptive->capacity;
+    int stalled, idle;
+
+    if (queued > adaptive->peak)
+    {
+        adaptive->peak = queued;
+    }
+    if (window >= ADAPT_WINDOW_NS)
+    {
+        stalled = adaptive->producerNs * 100 > window * ADAPT_STALL_PERCENT;
+        idle = adaptive->consumerNs * 100 > window * consumers * ADAPT_IDLE_PERCENT;
+
+        //both sides waiting means bursts the buffer is too small to absorb
+        if (stalled && idle)
+        {
+            capacity = capacity * 2 < adaptive->high ? capacity * 2 : adaptive->high;
+        }
+        //LiftR never waited and most of the buffer went unused
+        else if (adaptive->producerNs * 100 < window && adaptive->peak * 2 < capacity)
+        {
+            capacity = adaptive->peak * 2 > capacity / 2 ? adaptive->peak * 2 : capacity / 2;
+            capacity = capacity > adaptive->low ? capacity : adaptive->low;
+        }
+
+        adaptive->windowNs = now;
+        adaptive->producerNs = 0;
+        adaptive->consumerNs = 0;
+        adaptive->peak = queued;
+    }
+    return capacity;
+}
+
+/****************************************
+* NAME: adaptResized
+* IMPORT: controller, new capacity
+* EXPORT: none
+* PURPOSE: records the capacity the caller
+*          actually moved the buffer to
+****************************************/
+void adaptResized(Adaptive* adaptive, int capacity)
+{
+    if (capacity != adaptive->capacity)
+    {
+        if (adaptive->changes < ADAPT_HISTORY)
+        {
+            adaptive->historyCapacity[adaptive->changes] = capacity;
+            adaptive->historyNs[adaptive->changes] = statsNow() - adaptive->startNs;
+        }
+        adaptive->changes++;
+        adaptive->capacity = capacity;
+    }
+}
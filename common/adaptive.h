@@ -0,0 +1,46 @@
+/****************************************
+* AUTHOR: Andre de Moeller              
+* DATE: 19.10.26                        
+* PURPOSE: sizes the request buffer from
+*          how long LiftR and the lifts 
+*          spend blocked on each other  
+* LAST MODIFIED: 19.10.26               
+****************************************/
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+//blocked time is judged over windows of this length
+#define ADAPT_WINDOW_NS 50000000L
+
+//share of a window spent blocked that counts as stalled / idle
+#define ADAPT_STALL_PERCENT 5
+#define ADAPT_IDLE_PERCENT 5
+
+//capacity changes kept for the report
+#define ADAPT_HISTORY 64
+
+//no pointers, lives in shared memory for the processes build
+typedef struct
+{
+    int low;
+    int high;
+    int capacity;
+    int peak;
+    long startNs;
+    long windowNs;
+    long producerNs;
+    long consumerNs;
+    long producerTotalNs;
+    long consumerTotalNs;
+    int changes;
+    int historyCapacity[ADAPT_HISTORY];
+    long historyNs[ADAPT_HISTORY];
+} Adaptive;
+
+void adaptInit(Adaptive* adaptive, int capacity, int low, int high);
+void adaptProducer(Adaptive* adaptive, long ns);
+void adaptConsumer(Adaptive* adaptive, long ns);
+int adaptCheck(Adaptive* adaptive, int queued, int consumers);
+void adaptResized(Adaptive* adaptive, int capacity);
+
+#endif
@@ -0,0 +1,58 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: what the simulator core needs
+*          from threads or processes
+* LAST MODIFIED: 19.10.26
+****************************************/
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <stddef.h>
+
+#include "group.h"
+
+//the core only ever waits and wakes through these, with the lock held
+//on entry and exit of every wait
+typedef struct
+{
+    //--backend=<name> and the banner
+    const char* name;
+    const char* title;
+
+    //backend only options, 1 taken, -1 taken but bad, 0 not ours
+    int (*option)(const char* arg);
+    void (*usage)();
+
+    //number of errors, called once the run has been validated
+    int (*check)();
+
+    //memory every lift can see, size may be rounded up
+    void* (*share)(size_t* size, const char* name);
+    void (*unshare)(void* memory, size_t size);
+
+    //creates the lock and wait queues once the groups are known
+    void (*init)();
+    void (*lock)();
+    void (*unlock)();
+
+    //lifts wait for a request in their group, LiftR for a free slot
+    void (*waitRequest)(Group* group);
+    void (*wakeRequest)(Group* group);
+    void (*waitSpace)();
+    void (*wakeSpace)();
+
+    //simulated travel time between requests
+    void (*travel)();
+
+    //runs LiftR and every lift, returns once they have all finished
+    void (*run)();
+
+    //prints the backend's report and frees what init made
+    void (*finish)();
+} Backend;
+
+extern const Backend threadsBackend;
+extern const Backend processesBackend;
+
+#endif
@@ -0,0 +1,167 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: writes and reads sim_checkpoint,
+*          the state needed to carry on a
+*          run from part way through
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "checkpoint.h"
+
+/****************************************
+* NAME: checkpointSize
+* IMPORT: lifts, groups, queued requests
+* EXPORT: bytes in the snapshot
+* PURPOSE: header, lifts, groups, then
+*          requests
+****************************************/
+static size_t checkpointSize(int lifts, int groups, int queued)
+{
+    return sizeof(Checkpoint) + lifts * sizeof(LiftState) + (groups + queued) * 3 * sizeof(int);
+}
+
+/****************************************
+* NAME: checkpointReserve
+* IMPORT: snapshot (NULL for a new one),
+*         lifts, groups, queued requests
+* EXPORT: snapshot big enough (NULL if out
+*         of memory, the old one is freed)
+* PURPOSE: sizes the snapshot before the
+*          caller fills it in
+****************************************/
+Checkpoint* checkpointReserve(Checkpoint* checkpoint, int lifts, int groups, int queued)
+{
+    Checkpoint* sized = (Checkpoint*)realloc(checkpoint, checkpointSize(lifts, groups, queued));
+
+    if (sized == NULL)
+    {
+        free(checkpoint);
+        return NULL;
+    }
+    memcpy(sized->magic, CHECKPOINT_MAGIC, sizeof(sized->magic));
+    sized->lifts = lifts;
+    sized->groups = groups;
+    sized->queued = queued;
+    return sized;
+}
+
+/****************************************
+* NAME: checkpointGroups
+* IMPORT: snapshot
+* EXPORT: first group triple
+* PURPOSE: groups sit after the lifts
+****************************************/
+int* checkpointGroups(Checkpoint* checkpoint)
+{
+    return (int*)&checkpoint->lift[checkpoint->lifts];
+}
+
+/****************************************
+* NAME: checkpointRequests
+* IMPORT: snapshot
+* EXPORT: first queued request triple
+* PURPOSE: requests sit after the groups
+****************************************/
+int* checkpointRequests(Checkpoint* checkpoint)
+{
+    return checkpointGroups(checkpoint) + checkpoint->groups * 3;
+}
+
+/****************************************
+* NAME: checkpointWrite
+* IMPORT: snapshot, fsync it
+* EXPORT: 0, -1 on error
+* PURPOSE: writes a temporary file and
+*          renames it over the last one so
+*          a crash mid write keeps the old
+****************************************/
+int checkpointWrite(const Checkpoint* checkpoint, int durable)
+{
+    size_t size = checkpointSize(checkpoint->lifts, checkpoint->groups, checkpoint->queued), done = 0;
+    ssize_t written;
+    int fd, error = 0;
+
+    fd = open(CHECKPOINT_PATH ".tmp", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+    {
+        perror("Error: cannot write sim_checkpoint");
+        return -1;
+    }
+    while (done < size && error == 0)
+    {
+        written = write(fd, (const char*)checkpoint + done, size - done);
+        if (written < 0)
+        {
+            error = -1;
+        }
+        done += written > 0 ? written : 0;
+    }
+    if (error == 0 && durable && fsync(fd) != 0)
+    {
+        error = -1;
+    }
+    close(fd);
+
+    if (error == 0 && rename(CHECKPOINT_PATH ".tmp", CHECKPOINT_PATH) != 0)
+    {
+        error = -1;
+    }
+    if (error != 0)
+    {
+        perror("Error: cannot write sim_checkpoint");
+        unlink(CHECKPOINT_PATH ".tmp");
+    }
+    return error;
+}
+
+/****************************************
+* NAME: checkpointRead
+* IMPORT: none
+* EXPORT: snapshot (NULL if missing or
+*         damaged), caller frees it
+* PURPOSE: loads sim_checkpoint
+****************************************/
+Checkpoint* checkpointRead()
+{
+    Checkpoint header, *checkpoint = NULL;
+    struct stat info;
+    FILE* input;
+
+    input = fopen(CHECKPOINT_PATH, "rb");
+    if (input == NULL)
+    {
+        perror("Error: cannot open sim_checkpoint");
+        return NULL;
+    }
+
+    //the size has to agree with the counts in the header
+    if (fstat(fileno(input), &info) == 0 && fread(&header, sizeof(header), 1, input) == 1 &&
+        memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) == 0 &&
+        header.lifts > 0 && header.groups > 0 && header.queued >= 0 &&
+        (size_t)info.st_size == checkpointSize(header.lifts, header.groups, header.queued))
+    {
+        checkpoint = checkpointReserve(NULL, header.lifts, header.groups, header.queued);
+        if (checkpoint != NULL)
+        {
+            rewind(input);
+            if (fread(checkpoint, info.st_size, 1, input) != 1)
+            {
+                free(checkpoint);
+                checkpoint = NULL;
+            }
+        }
+    }
+    if (checkpoint == NULL)
+    {
+        printf("Error: sim_checkpoint is damaged\n");
+    }
+    fclose(input);
+    return checkpoint;
+}
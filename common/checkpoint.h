@@ -0,0 +1,52 @@
+/****************************************
+* AUTHOR: Andre de Moeller              
+* DATE: 19.10.26                        
+* PURPOSE: binary snapshots of a running
+*          simulation for --resume      
+* LAST MODIFIED: 19.10.26               
+****************************************/
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "queue.h"
+#include "adaptive.h"
+
+#define CHECKPOINT_PATH "sim_checkpoint"
+#define CHECKPOINT_MAGIC "LIFTCKP2"
+
+//what a lift carries from one request to the next
+typedef struct
+{
+    int prev;
+    int reqNo;
+    int totalMovement;
+} LiftState;
+
+//the lifts are followed by (low, high, lifts) per group, then queued
+//(origin, destination, priority) triples
+typedef struct
+{
+    char magic[8];
+    int lifts;
+    int groups;
+    int queued;
+    int totalMovements;
+    int totalRequests;
+    int floors;
+    int priority;
+    int adaptive;
+    long inputOffset;
+    long outputOffset;
+    long elapsedNs;
+    WaitStats waits;
+    Adaptive controller;
+    LiftState lift[];
+} Checkpoint;
+
+Checkpoint* checkpointReserve(Checkpoint* checkpoint, int lifts, int groups, int queued);
+int* checkpointGroups(Checkpoint* checkpoint);
+int* checkpointRequests(Checkpoint* checkpoint);
+int checkpointWrite(const Checkpoint* checkpoint, int durable);
+Checkpoint* checkpointRead();
+
+#endif
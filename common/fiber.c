@@ -0,0 +1,456 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: runs lifts as user space fibers
+*          multiplexed over a few worker
+*          threads, blocking on a queue or
+*          travelling yields the worker
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <ucontext.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "fiber.h"
+
+struct Fiber
+{
+    ucontext_t context;
+    ucontext_t* scheduler;
+    void* stack;
+    int num;
+    long wakeNs;
+    int finished;
+    pthread_mutex_t* unlock;
+    Fiber* next;
+};
+
+//scheduler state shared by every worker
+static pthread_mutex_t schedLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t schedWake;
+static Fiber* runHead = NULL;
+static Fiber* runTail = NULL;
+static Fiber** sleeping = NULL;
+static int sleepCount = 0;
+static int live = 0;
+static void (*liftBody)(int num);
+
+//figures for the report
+static int fiberCount = 0;
+static int workerCount = 0;
+static long switches = 0;
+static long runNs = 0;
+static double switchNs = 0;
+
+//the fiber running on this worker
+static __thread Fiber* current = NULL;
+
+static long now();
+static void start();
+static void* worker(void* arg);
+static void makeRunnable(Fiber* fiber);
+static void sleepPush(Fiber* fiber);
+static Fiber* sleepPop();
+static void yield(Fiber* self);
+static double calibrate();
+
+/****************************************
+* NAME: fiberRun
+* IMPORT: number of fibers, worker threads,
+*         body to run as fiber num (1..n)
+* EXPORT: none
+* PURPOSE: runs every fiber to completion
+****************************************/
+void fiberRun(int fibers, int workers, void (*body)(int num))
+{
+    pthread_condattr_t attr;
+    pthread_t* threads;
+    Fiber* fiber;
+    size_t page = sysconf(_SC_PAGESIZE);
+    long started;
+
+    //timed waits are measured on the same clock as wakeNs
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&schedWake, &attr);
+    pthread_condattr_destroy(&attr);
+
+    liftBody = body;
+    fiberCount = fibers;
+    workerCount = workers;
+    live = fibers;
+    sleeping = (Fiber**)malloc(fibers * sizeof(Fiber*));
+    switchNs = calibrate();
+
+    for (int ii = 1; ii <= fibers; ii++)
+    {
+        fiber = (Fiber*)calloc(1, sizeof(Fiber));
+        fiber->num = ii;
+
+        //guard page below the stack turns an overflow into a fault
+        fiber->stack = mmap(NULL, FIBER_STACK_SIZE + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (fiber->stack == MAP_FAILED)
+        {
+            perror("Error: cannot allocate fiber stack");
+            exit(1);
+        }
+        mprotect(fiber->stack, page, PROT_NONE);
+
+        getcontext(&fiber->context);
+        fiber->context.uc_stack.ss_sp = (char*)fiber->stack + page;
+        fiber->context.uc_stack.ss_size = FIBER_STACK_SIZE;
+        fiber->context.uc_link = NULL;
+        makecontext(&fiber->context, start, 0);
+
+        makeRunnable(fiber);
+    }
+
+    started = now();
+    threads = (pthread_t*)malloc(workers * sizeof(pthread_t));
+    for (int ii = 0; ii < workers; ii++)
+    {
+        if (pthread_create(&threads[ii], NULL, worker, NULL) != 0)
+        {
+            fprintf(stderr, "Error: cannot create fiber worker %d\n", ii + 1);
+            exit(1);
+        }
+    }
+    for (int ii = 0; ii < workers; ii++)
+    {
+        pthread_join(threads[ii], NULL);
+    }
+    runNs = now() - started;
+
+    free(threads);
+    free(sleeping);
+    pthread_cond_destroy(&schedWake);
+}
+
+/****************************************
+* NAME: fiberWait
+* IMPORT: queue to park on, held lock
+* EXPORT: none
+* PURPOSE: like pthread_cond_wait, the lock
+*          is released once this fiber is
+*          off the cpu and retaken on wake
+****************************************/
+void fiberWait(FiberQueue* queue, pthread_mutex_t* lock)
+{
+    Fiber* self = current;
+
+    self->next = queue->head;
+    queue->head = self;
+    self->unlock = lock;
+    yield(self);
+
+    pthread_mutex_lock(lock);
+}
+
+/****************************************
+* NAME: fiberWake
+* IMPORT: queue
+* EXPORT: none
+* PURPOSE: makes every parked fiber
+*          runnable (queue's lock held)
+****************************************/
+void fiberWake(FiberQueue* queue)
+{
+    Fiber* fiber;
+
+    while (queue->head != NULL)
+    {
+        fiber = queue->head;
+        queue->head = fiber->next;
+        makeRunnable(fiber);
+    }
+}
+
+/****************************************
+* NAME: fiberSleep
+* IMPORT: seconds
+* EXPORT: none
+* PURPOSE: simulated travel time, lets
+*          other lifts run meanwhile
+****************************************/
+void fiberSleep(int seconds)
+{
+    Fiber* self = current;
+
+    self->wakeNs = now() + seconds * 1000000000L;
+    yield(self);
+}
+
+/****************************************
+* NAME: fiberReport
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: prints memory and switch cost
+****************************************/
+void fiberReport()
+{
+    struct rusage usage;
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t perFiber = sizeof(Fiber) + FIBER_STACK_SIZE + page;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("Fiber engine: %d lifts on %d worker threads\n", fiberCount, workerCount);
+    printf("    Memory per lift: %zu bytes (%zu stack, %zu guard, %zu context)\n",
+           perFiber, (size_t)FIBER_STACK_SIZE, page, sizeof(Fiber));
+    printf("    Reserved for all lifts: %.1f MiB, peak RSS %.1f MiB\n",
+           perFiber * (double)fiberCount / (1024 * 1024), usage.ru_maxrss / 1024.0);
+    printf("    Context switches: %ld in %.3fs\n", switches, runNs / 1e9);
+    printf("    Switch cost: %.0f ns\n\n", switchNs);
+}
+
+/****************************************
+* NAME: now
+* IMPORT: none
+* EXPORT: monotonic time in nanoseconds
+* PURPOSE: clock for sleeping fibers
+****************************************/
+static long now()
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000000000L + time.tv_nsec;
+}
+
+/****************************************
+* NAME: start
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: first code a fiber runs, never
+*          returns (there is no uc_link)
+****************************************/
+static void start()
+{
+    Fiber* self = current;
+
+    liftBody(self->num);
+
+    self->finished = 1;
+    yield(self);
+}
+
+/****************************************
+* NAME: yield
+* IMPORT: running fiber
+* EXPORT: none
+* PURPOSE: switches back to the worker, the
+*          fiber may resume on another one
+****************************************/
+static void yield(Fiber* self)
+{
+    //only the fiber's own fields are safe to touch across the switch
+    swapcontext(&self->context, self->scheduler);
+}
+
+/****************************************
+* NAME: worker
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: worker thread, runs whatever
+*          fiber is ready until all finish
+****************************************/
+static void* worker(void* arg)
+{
+    ucontext_t scheduler;
+    struct timespec until;
+    pthread_mutex_t* lock;
+    Fiber* fiber;
+
+    pthread_mutex_lock(&schedLock);
+    while (live > 0)
+    {
+        //move fibers whose travel time is over onto the run queue
+        while (sleepCount > 0 && sleeping[0]->wakeNs <= now())
+        {
+            fiber = sleepPop();
+            fiber->wakeNs = 0;
+            fiber->next = NULL;
+            if (runTail == NULL)
+            {
+                runHead = fiber;
+            }
+            else
+            {
+                runTail->next = fiber;
+            }
+            runTail = fiber;
+        }
+
+        if (runHead == NULL)
+        {
+            if (sleepCount > 0)
+            {
+                until.tv_sec = sleeping[0]->wakeNs / 1000000000L;
+                until.tv_nsec = sleeping[0]->wakeNs % 1000000000L;
+                pthread_cond_timedwait(&schedWake, &schedLock, &until);
+            }
+            else
+            {
+                pthread_cond_wait(&schedWake, &schedLock);
+            }
+            continue;
+        }
+
+        fiber = runHead;
+        runHead = fiber->next;
+        if (runHead == NULL)
+        {
+            runTail = NULL;
+        }
+        switches++;
+        pthread_mutex_unlock(&schedLock);
+
+        //run it until it waits, travels or finishes
+        current = fiber;
+        fiber->scheduler = &scheduler;
+        swapcontext(&scheduler, &fiber->context);
+        current = NULL;
+
+        //its context is saved now, so it is safe to let others wake it,
+        //but once unlocked the fiber may already be running elsewhere
+        if (fiber->unlock != NULL)
+        {
+            lock = fiber->unlock;
+            fiber->unlock = NULL;
+            pthread_mutex_unlock(lock);
+            pthread_mutex_lock(&schedLock);
+            continue;
+        }
+
+        pthread_mutex_lock(&schedLock);
+        if (fiber->finished)
+        {
+            munmap(fiber->stack, FIBER_STACK_SIZE + sysconf(_SC_PAGESIZE));
+            free(fiber);
+            live--;
+            if (live == 0)
+            {
+                pthread_cond_broadcast(&schedWake);
+            }
+        }
+        else if (fiber->wakeNs > 0)
+        {
+            sleepPush(fiber);
+            pthread_cond_signal(&schedWake);
+        }
+    }
+    pthread_mutex_unlock(&schedLock);
+
+    return NULL;
+}
+
+/****************************************
+* NAME: makeRunnable
+* IMPORT: fiber
+* EXPORT: none
+* PURPOSE: appends a fiber to the run queue
+****************************************/
+static void makeRunnable(Fiber* fiber)
+{
+    pthread_mutex_lock(&schedLock);
+    fiber->next = NULL;
+    if (runTail == NULL)
+    {
+        runHead = fiber;
+    }
+    else
+    {
+        runTail->next = fiber;
+    }
+    runTail = fiber;
+    pthread_cond_signal(&schedWake);
+    pthread_mutex_unlock(&schedLock);
+}
+
+/****************************************
+* NAME: sleepPush / sleepPop
+* IMPORT: fiber / none
+* EXPORT: none / earliest fiber to wake
+* PURPOSE: binary min-heap on wakeNs
+*          (schedLock held)
+****************************************/
+static void sleepPush(Fiber* fiber)
+{
+    int ii = sleepCount++;
+
+    while (ii > 0 && sleeping[(ii - 1) / 2]->wakeNs > fiber->wakeNs)
+    {
+        sleeping[ii] = sleeping[(ii - 1) / 2];
+        ii = (ii - 1) / 2;
+    }
+    sleeping[ii] = fiber;
+}
+
+static Fiber* sleepPop()
+{
+    Fiber* top = sleeping[0];
+    Fiber* last = sleeping[--sleepCount];
+    int ii = 0, child;
+
+    while ((child = ii * 2 + 1) < sleepCount)
+    {
+        if (child + 1 < sleepCount && sleeping[child + 1]->wakeNs < sleeping[child]->wakeNs)
+        {
+            child++;
+        }
+        if (sleeping[child]->wakeNs >= last->wakeNs)
+        {
+            break;
+        }
+        sleeping[ii] = sleeping[child];
+        ii = child;
+    }
+    sleeping[ii] = last;
+
+    return top;
+}
+
+/****************************************
+* NAME: calibrate
+* IMPORT: none
+* EXPORT: nanoseconds per switch
+* PURPOSE: ping-pongs a trivial fiber to
+*          time one context switch
+****************************************/
+static ucontext_t pingMain, pingFiber;
+
+static void ping()
+{
+    while (1)
+    {
+        swapcontext(&pingFiber, &pingMain);
+    }
+}
+
+static double calibrate()
+{
+    char stack[16 * 1024];
+    int rounds = 100000;
+    long started;
+
+    getcontext(&pingFiber);
+    pingFiber.uc_stack.ss_sp = stack;
+    pingFiber.uc_stack.ss_size = sizeof(stack);
+    pingFiber.uc_link = NULL;
+    makecontext(&pingFiber, ping, 0);
+
+    started = now();
+    for (int ii = 0; ii < rounds; ii++)
+    {
+        swapcontext(&pingMain, &pingFiber);
+    }
+
+    //two switches per round
+    return (now() - started) / (rounds * 2.0);
+}
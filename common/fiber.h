@@ -0,0 +1,29 @@
+/****************************************
+* AUTHOR: Andre de Moeller              
+* DATE: 19.10.26                        
+* PURPOSE: fiber engine header file     
+* LAST MODIFIED: 19.10.26               
+****************************************/
+#ifndef FIBER_H
+#define FIBER_H
+
+#include <pthread.h>
+
+//usable stack per fiber, a guard page sits below it
+#define FIBER_STACK_SIZE (32 * 1024)
+
+typedef struct Fiber Fiber;
+
+//fibers parked until someone calls fiberWake
+typedef struct
+{
+    Fiber* head;
+} FiberQueue;
+
+void fiberRun(int fibers, int workers, void (*body)(int num));
+void fiberWait(FiberQueue* queue, pthread_mutex_t* lock);
+void fiberWake(FiberQueue* queue);
+void fiberSleep(int seconds);
+void fiberReport();
+
+#endif
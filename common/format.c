@@ -0,0 +1,154 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: formats sim_out blocks without
+*          going through printf, output is
+*          byte for byte the same as the
+*          old fprintf calls
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <string.h>
+
+#include "format.h"
+
+//copies a string literal, length is known at compile time
+#define PUT(at, literal) (memcpy((at), (literal), sizeof(literal) - 1), (at) + sizeof(literal) - 1)
+
+//"00" to "99", floors and most counters are one lookup
+static const char digits[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/****************************************
+* NAME: putInt
+* IMPORT: destination, value
+* EXPORT: end of the written digits
+* PURPOSE: writes an int in decimal,
+*          same as %d
+****************************************/
+static char* putInt(char* at, int value)
+{
+    char reversed[12];
+    unsigned int number = value;
+    int len = 0;
+
+    if (value < 0)
+    {
+        *at++ = '-';
+        number = 0u - number;
+    }
+
+    //the floor range, no loop needed
+    if (number < 10)
+    {
+        *at++ = '0' + number;
+        return at;
+    }
+    if (number < 100)
+    {
+        *at++ = digits[number * 2];
+        *at++ = digits[number * 2 + 1];
+        return at;
+    }
+
+    //bigger totals, two digits at a time from the right
+    while (number >= 100)
+    {
+        reversed[len++] = digits[(number % 100) * 2 + 1];
+        reversed[len++] = digits[(number % 100) * 2];
+        number /= 100;
+    }
+    if (number >= 10)
+    {
+        reversed[len++] = digits[number * 2 + 1];
+        reversed[len++] = digits[number * 2];
+    }
+    else
+    {
+        reversed[len++] = '0' + number;
+    }
+    while (len > 0)
+    {
+        *at++ = reversed[--len];
+    }
+    return at;
+}
+
+/****************************************
+* NAME: formatOperation
+* IMPORT: buffer (OUTPUT_RECORD_SIZE),
+*         relevant lift info
+* EXPORT: length written
+* PURPOSE: formats a lift operation block
+****************************************/
+int formatOperation(char* text, int num, int prev, int origin, int destination, int movement, int reqNo, int totalMovement)
+{
+    char* at = text;
+
+    at = PUT(at, "Lift-");
+    at = putInt(at, num);
+    at = PUT(at, " Operation\nPrevious Position: Floor ");
+    at = putInt(at, prev);
+    at = PUT(at, "\nRequest: Floor ");
+    at = putInt(at, origin);
+    at = PUT(at, " to Floor ");
+    at = putInt(at, destination);
+    at = PUT(at, "\nDetail operations:\nGo from: Floor ");
+    at = putInt(at, prev);
+    at = PUT(at, " to Floor ");
+    at = putInt(at, origin);
+    at = PUT(at, "\n    Go from: Floor ");
+    at = putInt(at, origin);
+    at = PUT(at, " to Floor ");
+    at = putInt(at, destination);
+    at = PUT(at, "\n    #Movement for this request: ");
+    at = putInt(at, movement);
+    at = PUT(at, "\n    #Request: ");
+    at = putInt(at, reqNo);
+    at = PUT(at, "\n    Total #movement: ");
+    at = putInt(at, totalMovement);
+    at = PUT(at, "\nCurrent position: ");
+    at = putInt(at, destination);
+    at = PUT(at, "\n\n");
+
+    return at - text;
+}
+
+/****************************************
+* NAME: formatRequest
+* IMPORT: buffer, origin, destination
+* EXPORT: length written
+* PURPOSE: formats a new request block
+****************************************/
+int formatRequest(char* text, int origin, int destination)
+{
+    char* at = text;
+
+    at = PUT(at, "-------------------------------------------------\nNew lift request from floor ");
+    at = putInt(at, origin);
+    at = PUT(at, " to floor ");
+    at = putInt(at, destination);
+    at = PUT(at, "\n-------------------------------------------------\n\n");
+
+    return at - text;
+}
+
+/****************************************
+* NAME: formatSummary
+* IMPORT: buffer, totals
+* EXPORT: length written
+* PURPOSE: formats the end of file summary
+****************************************/
+int formatSummary(char* text, int totalMovements, int totalRequests)
+{
+    char* at = text;
+
+    at = PUT(at, "\nTotal number of requests: ");
+    at = putInt(at, totalRequests);
+    at = PUT(at, "\nTotal number of movements: ");
+    at = putInt(at, totalMovements);
+    at = PUT(at, "\n");
+
+    return at - text;
+}
@@ -0,0 +1,14 @@
+/****************************************
+* AUTHOR: Andre de Moeller              
+* DATE: 19.10.26                        
+* PURPOSE: sim_out block formatting     
+* LAST MODIFIED: 19.10.26               
+****************************************/
+#ifndef FORMAT_H
+#define FORMAT_H
+
+int formatOperation(char* text, int num, int prev, int origin, int destination, int movement, int reqNo, int totalMovement);
+int formatRequest(char* text, int origin, int destination);
+int formatSummary(char* text, int totalMovements, int totalRequests);
+
+#endif
@@ -0,0 +1,27 @@
+/****************************************
+* AUTHOR: Andre de Moeller              
+* DATE: 19.10.26                        
+* PURPOSE: lift group (zone) struct     
+* LAST MODIFIED: 19.10.26               
+****************************************/
+#ifndef GROUP_H
+#define GROUP_H
+
+#include "request.h"
+#include "queue.h"
+
+//a bank of lifts serving one zone of floors from its own queue,
+//kept in memory every backend's lifts can see
+typedef struct 
+{
+    int low;
+    int high;
+    int lifts;
+    int firstLift;
+    Request* buffer;
+    Queue queue;
+    int requests;
+    int movements;
+} Group;
+
+#endif
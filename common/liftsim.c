@@ -0,0 +1,140 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 24.03.20
+* PURPOSE: lift simulator driver, picks
+*          the threads or processes
+*          backend at run time
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "backend.h"
+
+//each Makefile builds the same driver with its own default
+#ifndef DEFAULT_BACKEND
+#define DEFAULT_BACKEND threadsBackend
+#endif
+
+static const Backend* backends[] = { &threadsBackend, &processesBackend };
+#define BACKEND_COUNT (int)(sizeof(backends) / sizeof(backends[0]))
+
+int main(int argc, char* argv[])
+{
+    int error = 0, ii, jj, lineCount = 0, taken;
+    const char* unknown = NULL;
+
+    //the backend decides the banner, so find it before anything else
+    backend = &DEFAULT_BACKEND;
+    for (ii = 3; ii < argc; ii++)
+    {
+        if (strncmp(argv[ii], "--backend=", 10) == 0)
+        {
+            for (jj = 0; jj < BACKEND_COUNT; jj++)
+            {
+                if (strcmp(argv[ii] + 10, backends[jj]->name) == 0)
+                {
+                    backend = backends[jj];
+                }
+            }
+            if (strcmp(argv[ii] + 10, backend->name) != 0)
+            {
+                unknown = argv[ii] + 10;
+            }
+        }
+    }
+
+    printf("\n\n-------------------------------------------------\n");
+    printf("            LIFT SIMULATOR (%s)           \n", backend->title);
+    printf("-------------------------------------------------\n\n");
+
+    if (unknown != NULL)
+    {
+        printf("Error: unknown backend %s\n", unknown);
+        error++;
+    }
+    if (argc < 3)
+    {
+        printf("USAGE INFORMATION:\n");
+        printf("Run via %s <buffer_size> <time> [options]\n", argv[0]);
+        printf("    --backend=threads|processes\n");
+        printf("                              run the lifts as threads or as forked\n");
+        printf("                              processes (default %s)\n", backend->name);
+        simUsage();
+        for (jj = 0; jj < BACKEND_COUNT; jj++)
+        {
+            printf("  %s only:\n", backends[jj]->name);
+            backends[jj]->usage();
+        }
+    }
+    else
+    {
+        BUFFER_SIZE = atoi(argv[1]);
+        TIME = atoi(argv[2]);
+
+        //error checking
+        if (BUFFER_SIZE < 1)
+        {
+            printf("Error: buffer size must be >= 1\n");
+            error++;
+        }
+        if (TIME < 0)
+        {
+            printf("Error: time must be >= 0\n");
+            error++;
+        }
+        for (ii = 3; ii < argc; ii++)
+        {
+            if (strncmp(argv[ii], "--backend=", 10) == 0)
+            {
+                //already picked
+            }
+            else if ((taken = simOption(argv[ii])) != 0 || (taken = backend->option(argv[ii])) != 0)
+            {
+                error += taken < 0;
+            }
+            else
+            {
+                //say so when the option belongs to the other backend
+                for (jj = 0; jj < BACKEND_COUNT && taken == 0; jj++)
+                {
+                    if (backends[jj] != backend && backends[jj]->option(argv[ii]) != 0)
+                    {
+                        printf("Error: %s needs --backend=%s\n", argv[ii], backends[jj]->name);
+                        taken = 1;
+                    }
+                }
+                if (taken == 0)
+                {
+                    printf("Error: unknown option %s\n", argv[ii]);
+                }
+                error++;
+            }
+        }
+        //the assignment's 50 - 100 requests, unless replaying a long trace
+        if (REPLAY == 0)
+        {
+            lineCount = countLines();
+            if(lineCount < 50 || lineCount > 100)
+            {
+                printf("Error: sim_input needs 50 - 100 requests (--replay for longer traces)\n\n");
+                error++;
+            }
+        }
+        if (error == 0)
+        {
+            error = simCheck();
+        }
+        if (error == 0)
+        {
+            error = backend->check();
+        }
+        if (error == 0)
+        {
+            simulate();
+        }
+    }
+    return 0;
+}
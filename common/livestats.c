@@ -0,0 +1,287 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: publishes live counters in a
+*          seqlocked shared memory segment
+*          so readers never take the
+*          simulator's lock
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "livestats.h"
+
+/****************************************
+* NAME: statsNow
+* IMPORT: none
+* EXPORT: monotonic time in nanoseconds
+* PURPOSE: common clock for sim and reader
+****************************************/
+long statsNow()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+/****************************************
+* NAME: statsCreate
+* IMPORT: number of lifts, buffer size
+* EXPORT: mapped segment (NULL on error)
+* PURPOSE: creates /LIFTSTAT, must be done
+*          before forking so every process
+*          shares the mapping
+****************************************/
+LiveStats* statsCreate(int lifts, int bufferSize)
+{
+    LiveStats* stats;
+    size_t size = sizeof(LiveStats) + lifts * sizeof(LiftStats);
+    int fd;
+
+    //readable by anyone, only the simulator writes
+    fd = shm_open(LIVESTATS_NAME, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd == -1)
+    {
+        perror("Error: cannot create live statistics");
+        return NULL;
+    }
+    ftruncate(fd, size);
+    stats = (LiveStats*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (stats == MAP_FAILED)
+    {
+        perror("Error: cannot map live statistics");
+        shm_unlink(LIVESTATS_NAME);
+        return NULL;
+    }
+
+    memset(stats, 0, size);
+    stats->running = 1;
+    stats->lifts = lifts;
+    stats->bufferSize = bufferSize;
+    stats->startNs = statsNow();
+    stats->updatedNs = stats->startNs;
+
+    return stats;
+}
+
+/****************************************
+* NAME: beginWrite / endWrite
+* IMPORT: segment
+* EXPORT: none
+* PURPOSE: seqlock writer side, callers are
+*          already serialised by the sim lock
+****************************************/
+static void beginWrite(LiveStats* stats)
+{
+    __atomic_store_n(&stats->seq, stats->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void endWrite(LiveStats* stats)
+{
+    stats->updatedNs = statsNow();
+    __atomic_store_n(&stats->seq, stats->seq + 1, __ATOMIC_RELEASE);
+}
+
+/****************************************
+* NAME: statsEnqueue
+* IMPORT: segment, queue depth after it
+* EXPORT: none
+* PURPOSE: counts a request read by LiftR
+****************************************/
+void statsEnqueue(LiveStats* stats, int queueDepth)
+{
+    if (stats != NULL)
+    {
+        beginWrite(stats);
+        stats->enqueued++;
+        stats->queueDepth = queueDepth;
+        endWrite(stats);
+    }
+}
+
+/****************************************
+* NAME: statsServe
+* IMPORT: segment, lift number, new floor,
+*         movement, queue depth after it
+* EXPORT: none
+* PURPOSE: counts a request served by a lift
+****************************************/
+void statsServe(LiveStats* stats, int num, int floor, int movement, int queueDepth)
+{
+    if (stats != NULL && num >= 1 && num <= stats->lifts)
+    {
+        beginWrite(stats);
+        stats->served++;
+        stats->queueDepth = queueDepth;
+        stats->totalMovements += movement;
+        stats->lift[num - 1].floor = floor;
+        stats->lift[num - 1].requests++;
+        stats->lift[num - 1].movement += movement;
+        endWrite(stats);
+    }
+}
+
+/****************************************
+* NAME: statsRestore
+* IMPORT: segment, lift number, floor,
+*         requests served, movement
+* EXPORT: none
+* PURPOSE: puts back a lift's work from a
+*          checkpoint, its requests count
+*          as enqueued and served
+****************************************/
+void statsRestore(LiveStats* stats, int num, int floor, int requests, int movement)
+{
+    if (stats != NULL && num >= 1 && num <= stats->lifts)
+    {
+        beginWrite(stats);
+        stats->enqueued += requests;
+        stats->served += requests;
+        stats->totalMovements += movement;
+        stats->lift[num - 1].floor = floor;
+        stats->lift[num - 1].requests = requests;
+        stats->lift[num - 1].movement = movement;
+        endWrite(stats);
+    }
+}
+
+/****************************************
+* NAME: statsRewind
+* IMPORT: segment, run time before resume
+* EXPORT: none
+* PURPOSE: backdates the start so overall
+*          rates include restored requests
+****************************************/
+void statsRewind(LiveStats* stats, long elapsedNs)
+{
+    if (stats != NULL)
+    {
+        beginWrite(stats);
+        stats->startNs -= elapsedNs;
+        endWrite(stats);
+    }
+}
+
+/****************************************
+* NAME: statsResize
+* IMPORT: segment, new buffer size
+* EXPORT: none
+* PURPOSE: follows an adaptive buffer
+****************************************/
+void statsResize(LiveStats* stats, int bufferSize)
+{
+    if (stats != NULL)
+    {
+        beginWrite(stats);
+        stats->bufferSize = bufferSize;
+        endWrite(stats);
+    }
+}
+
+/****************************************
+* NAME: statsFinish
+* IMPORT: segment
+* EXPORT: none
+* PURPOSE: tells readers the sim has ended
+****************************************/
+void statsFinish(LiveStats* stats)
+{
+    if (stats != NULL)
+    {
+        beginWrite(stats);
+        stats->running = 0;
+        endWrite(stats);
+    }
+}
+
+/****************************************
+* NAME: statsDestroy
+* IMPORT: segment
+* EXPORT: none
+* PURPOSE: unmaps and removes /LIFTSTAT,
+*          attached readers keep their copy
+****************************************/
+void statsDestroy(LiveStats* stats)
+{
+    if (stats != NULL)
+    {
+        munmap(stats, sizeof(LiveStats) + stats->lifts * sizeof(LiftStats));
+        shm_unlink(LIVESTATS_NAME);
+    }
+}
+
+/****************************************
+* NAME: statsAttach
+* IMPORT: lifts (set to the lifts mapped)
+* EXPORT: read only segment (NULL if none)
+* PURPOSE: maps a running sim's statistics,
+*          the lift count comes from the
+*          segment's size since the header
+*          may not be written yet
+****************************************/
+LiveStats* statsAttach(int* lifts)
+{
+    LiveStats* stats;
+    struct stat info;
+    int fd;
+
+    fd = shm_open(LIVESTATS_NAME, O_RDONLY, 0);
+    if (fd == -1)
+    {
+        return NULL;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(LiveStats))
+    {
+        close(fd);
+        return NULL;
+    }
+    stats = (LiveStats*)mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    *lifts = (info.st_size - sizeof(LiveStats)) / sizeof(LiftStats);
+
+    return stats == MAP_FAILED ? NULL : stats;
+}
+
+/****************************************
+* NAME: statsSnapshot
+* IMPORT: segment, lifts mapped at attach,
+*         copy (room for that many lifts)
+* EXPORT: 0 once a consistent copy is taken
+* PURPOSE: seqlock reader side, retries
+*          while a writer is mid update
+****************************************/
+int statsSnapshot(const LiveStats* stats, int lifts, LiveStats* copy)
+{
+    //never the live lift count, it can change under a re-created segment
+    size_t size = sizeof(LiveStats) + lifts * sizeof(LiftStats);
+    unsigned before, after;
+
+    for (int tries = 0; tries < 1000; tries++)
+    {
+        before = __atomic_load_n(&stats->seq, __ATOMIC_ACQUIRE);
+        if (before & 1)
+        {
+            sched_yield();
+            continue;
+        }
+        memcpy(copy, stats, size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&stats->seq, __ATOMIC_RELAXED);
+        if (before == after)
+        {
+            copy->lifts = copy->lifts > lifts ? lifts : copy->lifts;
+            return 0;
+        }
+    }
+    return -1;
+}
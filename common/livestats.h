@@ -0,0 +1,49 @@
+/****************************************
+* AUTHOR: Andre de Moeller              
+* DATE: 19.10.26                        
+* PURPOSE: live statistics shared with  
+*          liftstat while a sim runs    
+* LAST MODIFIED: 19.10.26               
+****************************************/
+#ifndef LIVESTATS_H
+#define LIVESTATS_H
+
+//shared memory name liftstat looks for
+#define LIVESTATS_NAME "/LIFTSTAT"
+
+typedef struct
+{
+    int floor;
+    int requests;
+    int movement;
+} LiftStats;
+
+//seq is odd while a writer is part way through an update
+typedef struct
+{
+    unsigned seq;
+    int running;
+    int lifts;
+    int bufferSize;
+    long startNs;
+    long updatedNs;
+    int enqueued;
+    int served;
+    int queueDepth;
+    int totalMovements;
+    LiftStats lift[];
+} LiveStats;
+
+LiveStats* statsCreate(int lifts, int bufferSize);
+void statsEnqueue(LiveStats* stats, int queueDepth);
+void statsServe(LiveStats* stats, int num, int floor, int movement, int queueDepth);
+void statsRestore(LiveStats* stats, int num, int floor, int requests, int movement);
+void statsRewind(LiveStats* stats, long elapsedNs);
+void statsResize(LiveStats* stats, int bufferSize);
+void statsFinish(LiveStats* stats);
+void statsDestroy(LiveStats* stats);
+LiveStats* statsAttach(int* lifts);
+int statsSnapshot(const LiveStats* stats, int lifts, LiveStats* copy);
+long statsNow();
+
+#endif
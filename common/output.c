@@ -0,0 +1,558 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: writes sim_out either directly
+*          or asynchronously via io_uring
+*          or a pool of pwrite threads
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include "output.h"
+
+//a run of sim_out bytes waiting to be written at a fixed offset
+typedef struct Chunk
+{
+    struct Chunk* next;
+    struct iovec iov;
+    long offset;
+    size_t size;
+    char data[];
+} Chunk;
+
+//mapped io_uring submission and completion rings
+typedef struct
+{
+    int fd;
+    unsigned entries;
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    struct io_uring_sqe* sqes;
+    struct io_uring_cqe* cqes;
+    void *sqRing, *cqRing;
+    size_t sqRingSize, cqRingSize, sqesSize;
+} Ring;
+
+//state for this process
+static int fd = -1;
+static int backend = OUTPUT_SYNC;
+static int fsyncAtEnd = 0;
+static long* offset;
+
+//end of this process's last append, -1 before the first
+static long appended = -1;
+
+//chunk being filled and chunks waiting for a worker
+static Chunk* stage = NULL;
+static Chunk* head = NULL;
+static Chunk* tail = NULL;
+static int closing = 0;
+
+static Ring ring;
+static int workers = 0;
+static pthread_t worker[OUTPUT_WORKERS];
+static pthread_mutex_t queueLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queued = PTHREAD_COND_INITIALIZER;
+
+static int ringOpen();
+static void ringClose();
+static void* ringWorker(void* arg);
+static void* poolWorker(void* arg);
+static void writeAll(Chunk* chunk);
+static void push(Chunk* chunk);
+static Chunk* pop();
+
+/****************************************
+* NAME: outputOpen
+* IMPORT: file path, requested backend,
+*         fsync on close, shared offset
+* EXPORT: backend in use (-1 on error)
+* PURPOSE: opens sim_out for this process,
+*          offset is the next free byte and
+*          must be shared by every writer
+****************************************/
+int outputOpen(const char* path, int requested, int fsyncOnClose, long* nextOffset)
+{
+    fd = open(path, O_WRONLY | O_CREAT, 0644);
+    if (fd == -1)
+    {
+        perror("Error: cannot open sim_out");
+        return -1;
+    }
+    offset = nextOffset;
+    fsyncAtEnd = fsyncOnClose;
+    closing = 0;
+    appended = -1;
+    backend = requested;
+
+    //io_uring first, threads if the kernel refuses it
+    if (backend == OUTPUT_ASYNC || backend == OUTPUT_URING)
+    {
+        backend = OUTPUT_THREADS;
+        if (ringOpen() == 0)
+        {
+            if (pthread_create(&worker[0], NULL, ringWorker, NULL) == 0)
+            {
+                backend = OUTPUT_URING;
+                workers = 1;
+            }
+            else
+            {
+                ringClose();
+            }
+        }
+    }
+    if (backend == OUTPUT_THREADS)
+    {
+        for (workers = 0; workers < OUTPUT_WORKERS; workers++)
+        {
+            if (pthread_create(&worker[workers], NULL, poolWorker, NULL) != 0)
+            {
+                break;
+            }
+        }
+        //nothing to hand the writes to, write them ourselves
+        if (workers == 0)
+        {
+            backend = OUTPUT_SYNC;
+        }
+    }
+    return backend;
+}
+
+/****************************************
+* NAME: outputAppend
+* IMPORT: formatted text, length
+* EXPORT: none
+* PURPOSE: appends text to sim_out, callers
+*          must hold the simulation lock so
+*          offsets are handed out in order
+****************************************/
+void outputAppend(const char* data, size_t len)
+{
+    long at = *offset;
+    int scattered = at != appended;
+
+    *offset += len;
+    appended = *offset;
+
+    if (backend == OUTPUT_SYNC)
+    {
+        ssize_t written;
+        size_t done = 0;
+
+        while (done < len)
+        {
+            written = pwrite(fd, data + done, len - done, at + done);
+            if (written < 0 && errno != EINTR)
+            {
+                perror("Error: cannot write sim_out");
+                return;
+            }
+            done += written > 0 ? written : 0;
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&queueLock);
+
+    //only extend the chunk being filled if this lands right after it
+    if (stage != NULL && (stage->offset + stage->iov.iov_len != at || stage->iov.iov_len + len > stage->size))
+    {
+        push(stage);
+        stage = NULL;
+    }
+    if (stage == NULL)
+    {
+        //another writer got in since the last append (each lift process
+        //has its own stage), nothing will follow on so size to the record
+        size_t size = scattered || len > OUTPUT_CHUNK_SIZE ? len : OUTPUT_CHUNK_SIZE;
+
+        stage = (Chunk*)malloc(sizeof(Chunk) + size);
+        stage->next = NULL;
+        stage->iov.iov_base = stage->data;
+        stage->iov.iov_len = 0;
+        stage->offset = at;
+        stage->size = size;
+    }
+    memcpy(stage->data + stage->iov.iov_len, data, len);
+    stage->iov.iov_len += len;
+
+    //full chunks go straight out
+    if (stage->iov.iov_len == stage->size)
+    {
+        push(stage);
+        stage = NULL;
+    }
+
+    pthread_mutex_unlock(&queueLock);
+}
+
+/****************************************
+* NAME: outputSync
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: flushes what has been written
+*          so far to disk (synchronous
+*          backend, async writes may still
+*          be queued)
+****************************************/
+void outputSync()
+{
+    if (fd != -1 && fdatasync(fd) != 0)
+    {
+        perror("Error: cannot fsync sim_out");
+    }
+}
+
+/****************************************
+* NAME: outputClose
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: waits for queued writes, fsyncs
+*          if asked to and closes sim_out
+****************************************/
+void outputClose()
+{
+    pthread_mutex_lock(&queueLock);
+    if (stage != NULL)
+    {
+        push(stage);
+        stage = NULL;
+    }
+    closing = 1;
+    pthread_cond_broadcast(&queued);
+    pthread_mutex_unlock(&queueLock);
+
+    for (int ii = 0; ii < workers; ii++)
+    {
+        pthread_join(worker[ii], NULL);
+    }
+    workers = 0;
+
+    if (backend == OUTPUT_URING)
+    {
+        ringClose();
+    }
+    if (fsyncAtEnd && fsync(fd) != 0)
+    {
+        perror("Error: cannot fsync sim_out");
+    }
+    close(fd);
+    fd = -1;
+}
+
+/****************************************
+* NAME: outputName
+* IMPORT: backend
+* EXPORT: printable name
+* PURPOSE: names a backend for reports
+****************************************/
+const char* outputName(int which)
+{
+    const char* name = "the synchronous writer";
+
+    if (which == OUTPUT_URING)
+    {
+        name = "io_uring";
+    }
+    else if (which == OUTPUT_THREADS)
+    {
+        name = "pwrite threads";
+    }
+    return name;
+}
+
+/****************************************
+* NAME: push
+* IMPORT: chunk
+* EXPORT: none
+* PURPOSE: queues a chunk for the workers
+*          (queueLock held)
+****************************************/
+static void push(Chunk* chunk)
+{
+    chunk->next = NULL;
+    if (tail == NULL)
+    {
+        head = chunk;
+    }
+    else
+    {
+        tail->next = chunk;
+    }
+    tail = chunk;
+    pthread_cond_signal(&queued);
+}
+
+/****************************************
+* NAME: pop
+* IMPORT: none
+* EXPORT: oldest chunk (NULL when empty)
+* PURPOSE: takes a chunk off the queue
+*          (queueLock held)
+****************************************/
+static Chunk* pop()
+{
+    Chunk* chunk = head;
+
+    if (chunk != NULL)
+    {
+        head = chunk->next;
+        if (head == NULL)
+        {
+            tail = NULL;
+        }
+    }
+    return chunk;
+}
+
+/****************************************
+* NAME: writeAll
+* IMPORT: chunk
+* EXPORT: none
+* PURPOSE: pwrites whatever is left of a
+*          chunk and frees it
+****************************************/
+static void writeAll(Chunk* chunk)
+{
+    ssize_t written;
+
+    while (chunk->iov.iov_len > 0)
+    {
+        written = pwrite(fd, chunk->iov.iov_base, chunk->iov.iov_len, chunk->offset);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("Error: cannot write sim_out");
+            break;
+        }
+        chunk->iov.iov_base = (char*)chunk->iov.iov_base + written;
+        chunk->iov.iov_len -= written;
+        chunk->offset += written;
+    }
+    free(chunk);
+}
+
+/****************************************
+* NAME: poolWorker
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: pwrite thread, writes chunks
+*          until closed and drained
+****************************************/
+static void* poolWorker(void* arg)
+{
+    Chunk* chunk;
+
+    pthread_mutex_lock(&queueLock);
+    while (head != NULL || closing == 0)
+    {
+        chunk = pop();
+        if (chunk == NULL)
+        {
+            pthread_cond_wait(&queued, &queueLock);
+        }
+        else
+        {
+            pthread_mutex_unlock(&queueLock);
+            writeAll(chunk);
+            pthread_mutex_lock(&queueLock);
+        }
+    }
+    pthread_mutex_unlock(&queueLock);
+
+    return NULL;
+}
+
+/****************************************
+* NAME: ringOpen
+* IMPORT: none
+* EXPORT: 0 on success
+* PURPOSE: sets up an io_uring instance
+*          and maps its rings
+****************************************/
+static int ringOpen()
+{
+    struct io_uring_params params;
+    char* sq;
+    char* cq;
+
+    memset(&params, 0, sizeof(params));
+    memset(&ring, 0, sizeof(ring));
+
+    ring.fd = syscall(__NR_io_uring_setup, OUTPUT_RING_ENTRIES, &params);
+    if (ring.fd < 0)
+    {
+        return -1;
+    }
+    ring.entries = params.sq_entries;
+    ring.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring.sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    //newer kernels put both rings in the one mapping
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ring.cqRingSize > ring.sqRingSize)
+        {
+            ring.sqRingSize = ring.cqRingSize;
+        }
+        ring.cqRingSize = ring.sqRingSize;
+    }
+
+    ring.sqRing = mmap(NULL, ring.sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQ_RING);
+    if (ring.sqRing == MAP_FAILED)
+    {
+        close(ring.fd);
+        return -1;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        ring.cqRing = ring.sqRing;
+    }
+    else
+    {
+        ring.cqRing = mmap(NULL, ring.cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_CQ_RING);
+    }
+    ring.sqes = mmap(NULL, ring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+    if (ring.cqRing == MAP_FAILED || ring.sqes == MAP_FAILED)
+    {
+        ringClose();
+        return -1;
+    }
+
+    sq = (char*)ring.sqRing;
+    cq = (char*)ring.cqRing;
+    ring.sqHead = (unsigned*)(sq + params.sq_off.head);
+    ring.sqTail = (unsigned*)(sq + params.sq_off.tail);
+    ring.sqMask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring.sqArray = (unsigned*)(sq + params.sq_off.array);
+    ring.cqHead = (unsigned*)(cq + params.cq_off.head);
+    ring.cqTail = (unsigned*)(cq + params.cq_off.tail);
+    ring.cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    return 0;
+}
+
+/****************************************
+* NAME: ringClose
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: unmaps and closes the io_uring
+****************************************/
+static void ringClose()
+{
+    if (ring.sqes != NULL && ring.sqes != MAP_FAILED)
+    {
+        munmap(ring.sqes, ring.sqesSize);
+    }
+    if (ring.cqRing != NULL && ring.cqRing != MAP_FAILED && ring.cqRing != ring.sqRing)
+    {
+        munmap(ring.cqRing, ring.cqRingSize);
+    }
+    if (ring.sqRing != NULL && ring.sqRing != MAP_FAILED)
+    {
+        munmap(ring.sqRing, ring.sqRingSize);
+    }
+    close(ring.fd);
+    memset(&ring, 0, sizeof(ring));
+}
+
+/****************************************
+* NAME: ringWorker
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: submits queued chunks to the
+*          io_uring and reaps completions
+****************************************/
+static void* ringWorker(void* arg)
+{
+    struct io_uring_sqe* sqe;
+    struct io_uring_cqe* cqe;
+    Chunk* chunk;
+    unsigned sqTail, cqHead, submit, inflight = 0;
+
+    pthread_mutex_lock(&queueLock);
+    while (head != NULL || inflight > 0 || closing == 0)
+    {
+        //nothing to submit or reap, sleep until lifts queue more
+        if (head == NULL && inflight == 0)
+        {
+            pthread_cond_wait(&queued, &queueLock);
+            continue;
+        }
+
+        //fill as many submission slots as are free
+        submit = 0;
+        sqTail = *ring.sqTail;
+        while (head != NULL && inflight + submit < ring.entries)
+        {
+            chunk = pop();
+            sqe = &ring.sqes[sqTail & *ring.sqMask];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_WRITEV;
+            sqe->fd = fd;
+            sqe->addr = (unsigned long)&chunk->iov;
+            sqe->len = 1;
+            sqe->off = chunk->offset;
+            sqe->user_data = (unsigned long)chunk;
+            ring.sqArray[sqTail & *ring.sqMask] = sqTail & *ring.sqMask;
+            sqTail++;
+            submit++;
+        }
+        pthread_mutex_unlock(&queueLock);
+
+        __atomic_store_n(ring.sqTail, sqTail, __ATOMIC_RELEASE);
+        inflight += submit;
+        if (syscall(__NR_io_uring_enter, ring.fd, submit, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
+        {
+            perror("Error: io_uring_enter");
+        }
+
+        //reap everything that has completed
+        cqHead = *ring.cqHead;
+        while (cqHead != __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE))
+        {
+            cqe = &ring.cqes[cqHead & *ring.cqMask];
+            chunk = (Chunk*)(unsigned long)cqe->user_data;
+            if (cqe->res < 0 || (size_t)cqe->res < chunk->iov.iov_len)
+            {
+                //short or failed write, finish it the slow way
+                if (cqe->res > 0)
+                {
+                    chunk->iov.iov_base = (char*)chunk->iov.iov_base + cqe->res;
+                    chunk->iov.iov_len -= cqe->res;
+                    chunk->offset += cqe->res;
+                }
+                writeAll(chunk);
+            }
+            else
+            {
+                free(chunk);
+            }
+            inflight--;
+            cqHead++;
+        }
+        __atomic_store_n(ring.cqHead, cqHead, __ATOMIC_RELEASE);
+
+        pthread_mutex_lock(&queueLock);
+    }
+    pthread_mutex_unlock(&queueLock);
+
+    return NULL;
+}
@@ -0,0 +1,36 @@
+/****************************************
+* AUTHOR: Andre de Moeller              
+* DATE: 19.10.26                        
+* PURPOSE: sim_out output backends      
+* LAST MODIFIED: 19.10.26               
+****************************************/
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stddef.h>
+
+//output backends
+#define OUTPUT_SYNC 0
+#define OUTPUT_ASYNC 1
+#define OUTPUT_URING 2
+#define OUTPUT_THREADS 3
+
+//largest single formatted block written to sim_out
+#define OUTPUT_RECORD_SIZE 512
+
+//async writes are batched into chunks of this size
+#define OUTPUT_CHUNK_SIZE (64 * 1024)
+
+//pwrite threads used when io_uring is unavailable
+#define OUTPUT_WORKERS 2
+
+//io_uring submission queue depth
+#define OUTPUT_RING_ENTRIES 32
+
+int outputOpen(const char* path, int backend, int fsyncAtEnd, long* offset);
+void outputAppend(const char* data, size_t len);
+void outputSync();
+void outputClose();
+const char* outputName(int backend);
+
+#endif
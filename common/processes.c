@@ -0,0 +1,518 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: processes backend, each lift
+*          is a forked process on shared
+*          memory and named semaphores
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "sim.h"
+#include "output.h"
+
+//huge page size when the kernel doesn't say, x86-64's 2 MiB
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+//semaphore names, the request semaphores get the group number appended
+static const char* sem_mutex = "/SEMMUTEX";
+static const char* sem_space = "/SEMSPACE";
+static const char* sem_request = "/SEMREQUEST";
+
+//shared memory page options
+static int HUGEPAGES = 0;
+static int POPULATE = 0;
+
+//opened before forking, every lift inherits them
+static sem_t* mutex = NULL;
+static sem_t* space = NULL;
+static sem_t** requests = NULL;
+
+static int processesOption(const char* arg);
+static void processesUsage();
+static int processesCheck();
+static void* processesShare(size_t* size, const char* name);
+static void processesUnshare(void* memory, size_t size);
+static void processesInit();
+static void processesLock();
+static void processesUnlock();
+static void processesWaitRequest(Group* group);
+static void processesWakeRequest(Group* group);
+static void processesWaitSpace();
+static void processesWakeSpace();
+static void processesTravel();
+static void processesRun();
+static void processesFinish();
+static sem_t* openSemaphore(const char* name, int value);
+static int shmemHugePages();
+static size_t hugePageSize(const char* path, const char* format, size_t unit);
+static long hugeMapped(void* region);
+
+const Backend processesBackend =
+{
+    "processes", "Processes",
+    processesOption, processesUsage, processesCheck,
+    processesShare, processesUnshare,
+    processesInit, processesLock, processesUnlock,
+    processesWaitRequest, processesWakeRequest, processesWaitSpace, processesWakeSpace,
+    processesTravel, processesRun, processesFinish
+};
+
+/****************************************
+* NAME: processesOption
+* IMPORT: command line argument
+* EXPORT: 1 taken, 0 not a processes
+*         option
+* PURPOSE: parses shared memory options
+****************************************/
+static int processesOption(const char* arg)
+{
+    int taken = 1;
+
+    if (strcmp(arg, "--hugepages") == 0)
+    {
+        HUGEPAGES = 1;
+    }
+    else if (strcmp(arg, "--populate") == 0)
+    {
+        POPULATE = 1;
+    }
+    else
+    {
+        taken = 0;
+    }
+    return taken;
+}
+
+/****************************************
+* NAME: processesUsage
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: lists the processes options
+****************************************/
+static void processesUsage()
+{
+    printf("    --hugepages               back shared memory with huge pages\n");
+    printf("    --populate                pre-fault shared memory before forking\n");
+}
+
+/****************************************
+* NAME: processesCheck
+* IMPORT: none
+* EXPORT: number of errors
+* PURPOSE: nothing clashes with fork
+****************************************/
+static int processesCheck()
+{
+    return 0;
+}
+
+/****************************************
+* NAME: processesShare
+* IMPORT: size, region name
+* EXPORT: mapped region
+* PURPOSE: maps shared memory with the
+*          selected page options
+****************************************/
+static void* processesShare(size_t* size, const char* name)
+{
+    void* region = MAP_FAILED;
+    int flags = MAP_SHARED | MAP_ANONYMOUS;
+    long mapped;
+    char pages[64] = "4 KiB pages";
+    size_t page, huge;
+
+    if (HUGEPAGES)
+    {
+        //MAP_HUGETLB uses the default hugetlb size, mappings must be whole pages of it
+        page = hugePageSize("/proc/meminfo", "Hugepagesize: %zu kB", 1024);
+        huge = (*size + page - 1) / page * page;
+
+        //straight from the hugetlb pool if any pages are reserved
+        region = mmap(NULL, huge, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | (POPULATE ? MAP_POPULATE : 0), -1, 0);
+        if (region != MAP_FAILED)
+        {
+            *size = huge;
+            snprintf(pages, sizeof(pages), "%zu KiB hugetlb pages", page / 1024);
+        }
+    }
+    if (region == MAP_FAILED && HUGEPAGES && shmemHugePages())
+    {
+        //transparent huge pages come in PMD sized units
+        page = hugePageSize("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "%zu", 1);
+        huge = (*size + page - 1) / page * page;
+
+        //no reserved huge pages, ask for transparent ones instead
+        region = mmap(NULL, huge, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (region != MAP_FAILED)
+        {
+            *size = huge;
+            madvise(region, huge, MADV_HUGEPAGE);
+            strcpy(pages, "transparent huge pages advised");
+
+            //populate after the advice, otherwise the pages are already 4 KiB
+            if (POPULATE)
+            {
+                memset(region, 0, huge);
+                mapped = hugeMapped(region);
+                if (mapped >= 0)
+                {
+                    snprintf(pages, sizeof(pages), "%ld KiB in transparent huge pages", mapped);
+                }
+            }
+        }
+    }
+    if (region == MAP_FAILED)
+    {
+        //no huge pages to be had, don't pay for the rounding
+        if (HUGEPAGES)
+        {
+            strcpy(pages, "4 KiB pages, no huge pages available");
+        }
+        region = mmap(NULL, *size, PROT_READ | PROT_WRITE, flags | (POPULATE ? MAP_POPULATE : 0), -1, 0);
+    }
+
+    if (region == MAP_FAILED)
+    {
+        perror("Error: cannot map shared memory");
+        exit(1);
+    }
+    printf("    %s: %zu bytes, %s%s\n", name, *size, pages, POPULATE ? ", pre-faulted" : "");
+
+    return region;
+}
+
+/****************************************
+* NAME: shmemHugePages
+* IMPORT: none
+* EXPORT: 1 if shared memory can get
+*         transparent huge pages
+* PURPOSE: reads the selected shmem THP
+*          policy, never and deny rule
+*          them out
+****************************************/
+static int shmemHugePages()
+{
+    FILE* setting = fopen("/sys/kernel/mm/transparent_hugepage/shmem_enabled", "r");
+    char line[128];
+    int available = 0;
+
+    if (setting != NULL)
+    {
+        if (fgets(line, sizeof(line), setting) != NULL)
+        {
+            available = strstr(line, "[never]") == NULL && strstr(line, "[deny]") == NULL;
+        }
+        fclose(setting);
+    }
+    return available;
+}
+
+/****************************************
+* NAME: hugePageSize
+* IMPORT: file, scanf format for one line,
+*         bytes per unit read
+* EXPORT: huge page size in bytes
+* PURPOSE: reads the kernel's huge page
+*          size, HUGE_PAGE_SIZE if absent
+****************************************/
+static size_t hugePageSize(const char* path, const char* format, size_t unit)
+{
+    FILE* file = fopen(path, "r");
+    char line[128];
+    size_t size = 0;
+
+    if (file != NULL)
+    {
+        while (size == 0 && fgets(line, sizeof(line), file) != NULL)
+        {
+            if (sscanf(line, format, &size) != 1)
+            {
+                size = 0;
+            }
+        }
+        fclose(file);
+    }
+    return size > 0 ? size * unit : HUGE_PAGE_SIZE;
+}
+
+/****************************************
+* NAME: hugeMapped
+* IMPORT: region
+* EXPORT: KiB of the region mapped with
+*         huge pages, -1 if unknown
+* PURPOSE: reads ShmemPmdMapped for the
+*          region from smaps
+****************************************/
+static long hugeMapped(void* region)
+{
+    FILE* smaps = fopen("/proc/self/smaps", "r");
+    char line[256];
+    unsigned long start, end;
+    long mapped = -1;
+    int found = 0;
+
+    if (smaps == NULL)
+    {
+        return -1;
+    }
+    while (mapped < 0 && fgets(line, sizeof(line), smaps) != NULL)
+    {
+        //a new mapping starts with its address range
+        if (sscanf(line, "%lx-%lx", &start, &end) == 2)
+        {
+            found = start == (unsigned long)region;
+        }
+        else if (found)
+        {
+            sscanf(line, "ShmemPmdMapped: %ld kB", &mapped);
+        }
+    }
+    fclose(smaps);
+    return mapped;
+}
+
+/****************************************
+* NAME: processesUnshare
+* IMPORT: region, size
+* EXPORT: none
+* PURPOSE: unmaps a shared region
+****************************************/
+static void processesUnshare(void* memory, size_t size)
+{
+    munmap(memory, size);
+}
+
+/****************************************
+* NAME: processesInit
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: creates the mutex, the free
+*          slot semaphore and one request
+*          semaphore per group
+****************************************/
+static void processesInit()
+{
+    char name[32];
+
+    mutex = openSemaphore(sem_mutex, 1);
+    space = openSemaphore(sem_space, 0);
+    requests = (sem_t**)malloc(GROUPS * sizeof(sem_t*));
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        snprintf(name, sizeof(name), "%s%d", sem_request, ii + 1);
+        requests[ii] = openSemaphore(name, 0);
+    }
+}
+
+/****************************************
+* NAME: openSemaphore
+* IMPORT: name, initial value
+* EXPORT: semaphore
+* PURPOSE: creates a named semaphore,
+*          replacing one a crashed run
+*          left behind with a stale count
+****************************************/
+static sem_t* openSemaphore(const char* name, int value)
+{
+    sem_t* semaphore;
+
+    sem_unlink(name);
+    semaphore = sem_open(name, O_CREAT, 0644, value);
+    if (semaphore == SEM_FAILED)
+    {
+        perror("Error: cannot create semaphore");
+        exit(1);
+    }
+    return semaphore;
+}
+
+/****************************************
+* NAME: processesLock
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: takes the simulation mutex
+****************************************/
+static void processesLock()
+{
+    sem_wait(mutex);
+}
+
+/****************************************
+* NAME: processesUnlock
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: releases the simulation mutex
+****************************************/
+static void processesUnlock()
+{
+    sem_post(mutex);
+}
+
+/****************************************
+* NAME: processesWaitRequest
+* IMPORT: group
+* EXPORT: none
+* PURPOSE: blocks the lift until its
+*          group is posted, a post made
+*          between the unlock and the
+*          wait is kept by the semaphore
+****************************************/
+static void processesWaitRequest(Group* group)
+{
+    sem_post(mutex);
+    sem_wait(requests[group - groups]);
+    sem_wait(mutex);
+}
+
+/****************************************
+* NAME: processesWakeRequest
+* IMPORT: group
+* EXPORT: none
+* PURPOSE: wakes one lift in the group,
+*          the core passes it on when
+*          lifts finish
+****************************************/
+static void processesWakeRequest(Group* group)
+{
+    sem_post(requests[group - groups]);
+}
+
+/****************************************
+* NAME: processesWaitSpace
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: blocks LiftR until a lift
+*          takes from a full buffer
+****************************************/
+static void processesWaitSpace()
+{
+    sem_post(mutex);
+    sem_wait(space);
+    sem_wait(mutex);
+}
+
+/****************************************
+* NAME: processesWakeSpace
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: wakes LiftR
+****************************************/
+static void processesWakeSpace()
+{
+    sem_post(space);
+}
+
+/****************************************
+* NAME: processesTravel
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: simulates the travel time
+****************************************/
+static void processesTravel()
+{
+    sleep(TIME);
+}
+
+/****************************************
+* NAME: processesRun
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: forks a process per lift, the
+*          parent is LiftR
+****************************************/
+static void processesRun()
+{
+    pid_t* pid = (pid_t*)malloc(LIFTS * sizeof(pid_t));
+    int status = 0, failed = 0;
+
+    printf("Creating processes...\n\n");
+
+    //flush so children don't inherit (and reprint) buffered output
+    fflush(stdout);
+
+    for (int ii = 0; ii < LIFTS; ii++)
+    {
+        pid[ii] = fork();
+        if (pid[ii] == 0)
+        {
+            printf("    Lift%d started!\n", ii + 1);
+
+            //each process needs its own sim_out writers
+            openOutput(0);
+            lift((void*)(intptr_t)(ii + 1));
+
+            //wait for this lift's sim_out writes
+            outputClose();
+            exit(0);
+        }
+        else if (pid[ii] < 0)
+        {
+            printf("Error: process could not be created\n");
+            failed++;
+        }
+    }
+
+    printf("    LiftR started!\n");
+    openOutput(1);
+    if (failed == 0)
+    {
+        request();
+    }
+    else
+    {
+        //a group may have no lift, don't read requests it could never serve
+        finishRequests();
+    }
+    printf("Waiting for children to terminate...\n\n");
+
+    for (int ii = 0; ii < LIFTS; ii++)
+    {
+        if (pid[ii] > 0)
+        {
+            waitpid(pid[ii], &status, 0);
+        }
+    }
+    free(pid);
+}
+
+/****************************************
+* NAME: processesFinish
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: page fault report, removes
+*          the semaphores
+****************************************/
+static void processesFinish()
+{
+    struct rusage self, children;
+    char name[32];
+
+    //page faults for liftR and every lift process
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_CHILDREN, &children);
+    printf("Page faults (minor/major):\n");
+    printf("    LiftR: %ld/%ld\n", self.ru_minflt, self.ru_majflt);
+    printf("    Lifts: %ld/%ld\n\n", children.ru_minflt, children.ru_majflt);
+
+    sem_close(mutex);
+    sem_close(space);
+    sem_unlink(sem_mutex);
+    sem_unlink(sem_space);
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        snprintf(name, sizeof(name), "%s%d", sem_request, ii + 1);
+        sem_close(requests[ii]);
+        sem_unlink(name);
+    }
+    free(requests);
+}
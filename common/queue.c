@@ -0,0 +1,176 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: request queue with one ring per
+*          priority, push and pop are O(1)
+*          and FIFO within a priority
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "queue.h"
+
+/****************************************
+* NAME: queueInit
+* IMPORT: queue, capacity
+* EXPORT: none
+* PURPOSE: empties the queue, capacity is
+*          the total across all priorities
+****************************************/
+void queueInit(Queue* queue, int capacity)
+{
+    memset(queue, 0, sizeof(Queue));
+    queue->capacity = capacity;
+}
+
+/****************************************
+* NAME: queuePush
+* IMPORT: queue, slots, request
+* EXPORT: none
+* PURPOSE: adds request behind others of
+*          the same priority (not full)
+****************************************/
+void queuePush(Queue* queue, Request* slots, Request request)
+{
+    int level = request.priority;
+    int slot = (queue->head[level] + queue->size[level]) % queue->capacity;
+
+    slots[level * queue->capacity + slot] = request;
+    queue->size[level]++;
+    queue->count++;
+    queue->nonEmpty |= 1 << level;
+}
+
+/****************************************
+* NAME: queuePop
+* IMPORT: queue, slots
+* EXPORT: oldest most urgent request
+* PURPOSE: removes request (not empty)
+****************************************/
+Request queuePop(Queue* queue, Request* slots)
+{
+    //highest set bit is the most urgent non empty ring
+    int level = 31 - __builtin_clz(queue->nonEmpty);
+    Request request = slots[level * queue->capacity + queue->head[level]];
+
+    queue->head[level] = (queue->head[level] + 1) % queue->capacity;
+    queue->size[level]--;
+    queue->count--;
+    if (queue->size[level] == 0)
+    {
+        queue->nonEmpty &= ~(1 << level);
+    }
+    return request;
+}
+
+/****************************************
+* NAME: queueAt
+* IMPORT: queue, slots, position
+* EXPORT: request that many pops away
+* PURPOSE: reads the queue in pop order
+*          without changing it
+****************************************/
+Request queueAt(const Queue* queue, const Request* slots, int index)
+{
+    int level = PRIORITY_LEVELS - 1;
+
+    while (index >= queue->size[level])
+    {
+        index -= queue->size[level];
+        level--;
+    }
+    return slots[level * queue->capacity + (queue->head[level] + index) % queue->capacity];
+}
+
+/****************************************
+* NAME: queueResize
+* IMPORT: queue, slots, new capacity
+* EXPORT: 0, -1 if out of memory
+* PURPOSE: lays the queued requests out
+*          for a new capacity, keeping their
+*          order (slots must hold the larger
+*          of the two, capacity >= count)
+****************************************/
+int queueResize(Queue* queue, Request* slots, int capacity)
+{
+    int count = queue->count;
+    Request* held = (Request*)malloc((count > 0 ? count : 1) * sizeof(Request));
+
+    if (held == NULL)
+    {
+        return -1;
+    }
+
+    //the rings move when capacity does, so lift everything out first
+    for (int ii = 0; ii < count; ii++)
+    {
+        held[ii] = queuePop(queue, slots);
+    }
+    queueInit(queue, capacity);
+    for (int ii = 0; ii < count; ii++)
+    {
+        queuePush(queue, slots, held[ii]);
+    }
+
+    free(held);
+    return 0;
+}
+
+/****************************************
+* NAME: waitRecord
+* IMPORT: wait stats, priority, wait
+* EXPORT: none
+* PURPOSE: adds a wait to the histogram
+****************************************/
+void waitRecord(WaitStats* waits, int priority, long ns)
+{
+    int bucket = 0, power;
+
+    if (ns > 0)
+    {
+        //power of two, then the next two bits pick one of 4 sub-buckets
+        power = 63 - __builtin_clzl(ns);
+        bucket = power * 4;
+        if (power >= 2)
+        {
+            bucket += (ns >> (power - 2)) & 3;
+        }
+    }
+    waits->count[priority]++;
+    waits->totalNs[priority] += ns;
+    waits->histogram[priority][bucket]++;
+}
+
+/****************************************
+* NAME: waitPercentile
+* IMPORT: wait stats, priority, percent
+* EXPORT: wait in ns (upper bucket bound)
+* PURPOSE: reads a percentile back out of
+*          the histogram
+****************************************/
+long waitPercentile(const WaitStats* waits, int priority, double percent)
+{
+    long seen = 0, target = (long)(waits->count[priority] * percent / 100.0 + 0.999999);
+    int power;
+
+    if (target < 1)
+    {
+        target = 1;
+    }
+    for (int bucket = 0; bucket < WAIT_BUCKETS; bucket++)
+    {
+        seen += waits->histogram[priority][bucket];
+        if (seen >= target)
+        {
+            //top of this bucket
+            power = bucket / 4;
+            if (power < 2)
+            {
+                return (2L << power) - 1;
+            }
+            return (1L << power) + ((long)(bucket % 4 + 1) << (power - 2)) - 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+/****************************************
+* AUTHOR: Andre de Moeller              
+* DATE: 19.10.26                        
+* PURPOSE: bucketed priority queue and  
+*          per priority wait times      
+* LAST MODIFIED: 19.10.26               
+****************************************/
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "request.h"
+
+//priority 0 is a normal call, higher levels are served first
+#define PRIORITY_LEVELS 3
+
+//wait time histogram, 4 buckets per power of two nanoseconds
+#define WAIT_BUCKETS (64 * 4)
+
+//queue header, the slots (PRIORITY_LEVELS * capacity requests) live
+//separately so both can be placed in shared memory
+typedef struct
+{
+    int capacity;
+    int count;
+    int nonEmpty;
+    int head[PRIORITY_LEVELS];
+    int size[PRIORITY_LEVELS];
+} Queue;
+
+typedef struct
+{
+    long count[PRIORITY_LEVELS];
+    long totalNs[PRIORITY_LEVELS];
+    long histogram[PRIORITY_LEVELS][WAIT_BUCKETS];
+} WaitStats;
+
+void queueInit(Queue* queue, int capacity);
+void queuePush(Queue* queue, Request* slots, Request request);
+Request queuePop(Queue* queue, Request* slots);
+Request queueAt(const Queue* queue, const Request* slots, int index);
+int queueResize(Queue* queue, Request* slots, int capacity);
+void waitRecord(WaitStats* waits, int priority, long ns);
+long waitPercentile(const WaitStats* waits, int priority, double percent);
+
+#endif
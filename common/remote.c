@@ -0,0 +1,253 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: sockets and framing for the
+*          dispatcher and remote lifts,
+*          addresses are unix:<path> or
+*          tcp:<host>:<port>
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <netdb.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "remote.h"
+
+static int openSocket(const char* address, int listening);
+static int readAll(int fd, void* data, size_t len);
+static int writeAll(int fd, const void* data, size_t len);
+
+/****************************************
+* NAME: remoteListen
+* IMPORT: address
+* EXPORT: listening socket (-1 on error)
+* PURPOSE: dispatcher side
+****************************************/
+int remoteListen(const char* address)
+{
+    return openSocket(address, 1);
+}
+
+/****************************************
+* NAME: remoteConnect
+* IMPORT: address
+* EXPORT: connected socket (-1 on error)
+* PURPOSE: lift worker side
+****************************************/
+int remoteConnect(const char* address)
+{
+    return openSocket(address, 0);
+}
+
+/****************************************
+* NAME: remoteSend
+* IMPORT: socket, type, ints, how many
+* EXPORT: 0 on success
+* PURPOSE: sends one framed message
+****************************************/
+int remoteSend(int fd, int type, const int* values, int count)
+{
+    uint32_t message[2 + REMOTE_MAX_INTS];
+
+    if (count > REMOTE_MAX_INTS)
+    {
+        return -1;
+    }
+    message[0] = htonl(count * sizeof(uint32_t));
+    message[1] = htonl(type);
+    for (int ii = 0; ii < count; ii++)
+    {
+        message[2 + ii] = htonl((uint32_t)values[ii]);
+    }
+    return writeAll(fd, message, (2 + count) * sizeof(uint32_t));
+}
+
+/****************************************
+* NAME: remoteReceive
+* IMPORT: socket, room for max ints
+* EXPORT: ints received (-1 on error or
+*         when the other side hung up)
+* PURPOSE: receives one framed message
+****************************************/
+int remoteReceive(int fd, int* type, int* values, int max)
+{
+    uint32_t header[2];
+    int count;
+
+    if (readAll(fd, header, sizeof(header)) != 0)
+    {
+        return -1;
+    }
+    count = ntohl(header[0]) / sizeof(uint32_t);
+    *type = ntohl(header[1]);
+    if (count > max)
+    {
+        fprintf(stderr, "Error: message of %d ints is too large\n", count);
+        return -1;
+    }
+    if (readAll(fd, values, count * sizeof(uint32_t)) != 0)
+    {
+        return -1;
+    }
+    for (int ii = 0; ii < count; ii++)
+    {
+        values[ii] = (int)ntohl((uint32_t)values[ii]);
+    }
+    return count;
+}
+
+/****************************************
+* NAME: openSocket
+* IMPORT: address, listen or connect
+* EXPORT: socket (-1 on error)
+* PURPOSE: parses the address and sets up
+*          a unix or tcp socket
+****************************************/
+static int openSocket(const char* address, int listening)
+{
+    struct sockaddr_un local;
+    struct addrinfo hints, *found, *each;
+    char host[256], port[16];
+    int fd = -1, on = 1;
+    const char* split;
+
+    if (strncmp(address, "unix:", 5) == 0)
+    {
+        memset(&local, 0, sizeof(local));
+        local.sun_family = AF_UNIX;
+        strncpy(local.sun_path, address + 5, sizeof(local.sun_path) - 1);
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listening)
+        {
+            //a stale socket file from an earlier run would block bind
+            unlink(local.sun_path);
+            if (bind(fd, (struct sockaddr*)&local, sizeof(local)) != 0 || listen(fd, 64) != 0)
+            {
+                perror("Error: cannot listen");
+                close(fd);
+                fd = -1;
+            }
+        }
+        else if (connect(fd, (struct sockaddr*)&local, sizeof(local)) != 0)
+        {
+            perror("Error: cannot connect");
+            close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+
+    //tcp:<host>:<port>, the port is after the last colon
+    split = strrchr(address, ':');
+    if (strncmp(address, "tcp:", 4) != 0 || split == address + 3 || split - address - 4 >= (long)sizeof(host))
+    {
+        fprintf(stderr, "Error: address must be unix:<path> or tcp:<host>:<port>\n");
+        return -1;
+    }
+    memcpy(host, address + 4, split - address - 4);
+    host[split - address - 4] = '\0';
+    strncpy(port, split + 1, sizeof(port) - 1);
+    port[sizeof(port) - 1] = '\0';
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listening ? AI_PASSIVE : 0;
+    if (getaddrinfo(host[0] ? host : NULL, port, &hints, &found) != 0)
+    {
+        fprintf(stderr, "Error: cannot resolve %s\n", address);
+        return -1;
+    }
+    for (each = found; each != NULL && fd == -1; each = each->ai_next)
+    {
+        fd = socket(each->ai_family, each->ai_socktype, each->ai_protocol);
+        if (fd == -1)
+        {
+            continue;
+        }
+        if (listening)
+        {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            if (bind(fd, each->ai_addr, each->ai_addrlen) != 0 || listen(fd, 64) != 0)
+            {
+                close(fd);
+                fd = -1;
+            }
+        }
+        else if (connect(fd, each->ai_addr, each->ai_addrlen) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(found);
+
+    if (fd == -1)
+    {
+        fprintf(stderr, "Error: cannot %s %s\n", listening ? "listen on" : "connect to", address);
+    }
+    else
+    {
+        //batches are small, don't let Nagle hold them back
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    return fd;
+}
+
+/****************************************
+* NAME: readAll / writeAll
+* IMPORT: socket, data, length
+* EXPORT: 0 once every byte has moved
+* PURPOSE: loops over short reads/writes
+****************************************/
+static int readAll(int fd, void* data, size_t len)
+{
+    ssize_t got;
+
+    while (len > 0)
+    {
+        got = read(fd, data, len);
+        if (got <= 0)
+        {
+            if (got < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        data = (char*)data + got;
+        len -= got;
+    }
+    return 0;
+}
+
+static int writeAll(int fd, const void* data, size_t len)
+{
+    ssize_t sent;
+
+    while (len > 0)
+    {
+        sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        data = (const char*)data + sent;
+        len -= sent;
+    }
+    return 0;
+}
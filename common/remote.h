@@ -0,0 +1,28 @@
+/****************************************
+* AUTHOR: Andre de Moeller              
+* DATE: 19.10.26                        
+* PURPOSE: dispatcher/worker protocol   
+* LAST MODIFIED: 19.10.26               
+****************************************/
+#ifndef REMOTE_H
+#define REMOTE_H
+
+//message types, every message is
+//[payload bytes][type][payload ints], all in network byte order
+#define REMOTE_WELCOME 1
+#define REMOTE_BATCH 2
+#define REMOTE_RESULTS 3
+
+//ints per request in a batch and per result
+#define REMOTE_REQUEST_INTS 2
+#define REMOTE_RESULT_INTS 6
+
+//largest payload either side will accept
+#define REMOTE_MAX_INTS (1024 * REMOTE_RESULT_INTS)
+
+int remoteListen(const char* address);
+int remoteConnect(const char* address);
+int remoteSend(int fd, int type, const int* values, int count);
+int remoteReceive(int fd, int* type, int* values, int max);
+
+#endif
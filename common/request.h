@@ -2,7 +2,7 @@
 * AUTHOR: Andre de Moeller              
 * DATE: 24.03.20						
 * PURPOSE: request struct               
-* LAST MODIFIED: 07.05.20			
+* LAST MODIFIED: 19.10.26
 ****************************************/
 #ifndef REQUEST_H
 #define REQUEST_H
@@ -11,6 +11,8 @@ typedef struct
 {
   int origin;
   int destination;
+  int priority;
+  long queued;
 } Request;
 
 #endif
@@ -0,0 +1,1136 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: simulator core, LiftR and the
+*          lifts written once against the
+*          backend interface
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include "sim.h"
+#include "output.h"
+#include "format.h"
+
+//user-defined variables
+int BUFFER_SIZE;
+int TIME;
+
+//building layout, one group covering every floor unless --group is given
+int FLOORS = 20;
+int GROUPS = 0;
+int LIFTS = 0;
+
+//sim_out backend
+int OUTPUT = OUTPUT_SYNC;
+int FSYNC = 0;
+
+//live statistics for liftstat
+int STATS = 0;
+
+//urgent/VIP calls jump the queue, wait times kept per priority
+int PRIORITY = 0;
+
+//adaptive mode resizes every group's buffer within these bounds
+int ADAPTIVE = 0;
+int ADAPT_LOW = 0;
+int ADAPT_HIGH = 0;
+
+//snapshot every CHECKPOINT requests read, RESUME carries on from the last
+int CHECKPOINT = 0;
+int RESUME = 0;
+
+//long traces, no 50 - 100 request limit on sim_input
+int REPLAY = 0;
+
+//threads or processes, picked by the driver
+const Backend* backend = NULL;
+
+//state, groups and lifts are all in the backend's shared memory
+SimState* sim = NULL;
+Group* groups = NULL;
+LiftState* liftStates = NULL;
+LiveStats* stats = NULL;
+Checkpoint* checkpoint = NULL;
+
+/****************************************
+* NAME: simOption
+* IMPORT: command line argument
+* EXPORT: 1 taken, -1 taken but bad,
+*         0 not a simulator option
+* PURPOSE: parses the options every
+*          backend understands
+****************************************/
+int simOption(const char* arg)
+{
+    int taken = 1, low, high, lifts;
+
+    if (strcmp(arg, "--async") == 0)
+    {
+        OUTPUT = OUTPUT_ASYNC;
+    }
+    else if (strcmp(arg, "--async=uring") == 0)
+    {
+        OUTPUT = OUTPUT_URING;
+    }
+    else if (strcmp(arg, "--async=threads") == 0)
+    {
+        OUTPUT = OUTPUT_THREADS;
+    }
+    else if (strcmp(arg, "--fsync") == 0)
+    {
+        FSYNC = 1;
+    }
+    else if (strcmp(arg, "--stats") == 0)
+    {
+        STATS = 1;
+    }
+    else if (strcmp(arg, "--priority") == 0)
+    {
+        PRIORITY = 1;
+    }
+    else if (sscanf(arg, "--adaptive=%d-%d", &ADAPT_LOW, &ADAPT_HIGH) == 2)
+    {
+        ADAPTIVE = 1;
+        if (ADAPT_LOW < 1 || ADAPT_LOW > BUFFER_SIZE || ADAPT_HIGH < BUFFER_SIZE)
+        {
+            printf("Error: adaptive bounds must satisfy 1 <= min <= buffer_size <= max\n");
+            taken = -1;
+        }
+    }
+    else if (sscanf(arg, "--checkpoint=%d", &CHECKPOINT) == 1)
+    {
+        if (CHECKPOINT < 1)
+        {
+            printf("Error: checkpoint interval must be >= 1\n");
+            taken = -1;
+        }
+    }
+    else if (strcmp(arg, "--resume") == 0)
+    {
+        RESUME = 1;
+    }
+    else if (strcmp(arg, "--replay") == 0)
+    {
+        REPLAY = 1;
+    }
+    else if (sscanf(arg, "--floors=%d", &FLOORS) == 1)
+    {
+        if (FLOORS < 1)
+        {
+            printf("Error: floors must be >= 1\n");
+            taken = -1;
+        }
+    }
+    else if (sscanf(arg, "--group=%d-%d:%d", &low, &high, &lifts) == 3)
+    {
+        groups = (Group*)realloc(groups, (GROUPS + 1) * sizeof(Group));
+        groups[GROUPS].low = low;
+        groups[GROUPS].high = high;
+        groups[GROUPS].lifts = lifts;
+        GROUPS++;
+    }
+    else
+    {
+        taken = 0;
+    }
+    return taken;
+}
+
+/****************************************
+* NAME: simUsage
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: lists the simulator options
+****************************************/
+void simUsage()
+{
+    printf("    --async[=uring|threads]   write sim_out off the lifts' critical path\n");
+    printf("    --fsync                   fsync sim_out before exiting\n");
+    printf("    --stats                   publish live statistics for liftstat\n");
+    printf("    --floors=<n>              number of floors (default 20)\n");
+    printf("    --group=<low>-<high>:<n>  add a group of n lifts for that zone,\n");
+    printf("                              repeat for each zone (default 1-20:3)\n");
+    printf("    --priority                read a priority (0-%d) after each request\n", PRIORITY_LEVELS - 1);
+    printf("    --adaptive=<min>-<max>    resize the buffer between min and max\n");
+    printf("                              from how long each side is blocked\n");
+    printf("    --checkpoint=<n>          snapshot the run to sim_checkpoint every\n");
+    printf("                              n requests read\n");
+    printf("    --resume                  carry on from sim_checkpoint\n");
+    printf("    --replay                  take a sim_input of any length, not\n");
+    printf("                              just 50 - 100 requests\n");
+}
+
+/****************************************
+* NAME: simCheck
+* IMPORT: none
+* EXPORT: number of errors
+* PURPOSE: validates the options taken
+*          together
+****************************************/
+int simCheck()
+{
+    int error = checkGroups();
+
+    if ((CHECKPOINT > 0 || RESUME) && OUTPUT != OUTPUT_SYNC)
+    {
+        printf("Error: checkpoints need the synchronous sim_out writer\n");
+        error++;
+    }
+    if (error == 0 && RESUME)
+    {
+        error = checkResume();
+    }
+    return error;
+}
+
+/****************************************
+* NAME: simulate
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: sets up shared memory, runs
+*          the backend and writes the
+*          end of sim_out
+****************************************/
+void simulate()
+{
+    //buffers are mapped at the largest size the adaptive mode may grow to
+    int capacity = ADAPTIVE ? ADAPT_HIGH : BUFFER_SIZE;
+    size_t memorySize, bufferSize;
+    Group* parsed = groups;
+    char* memory;
+    Request* buffer;
+
+    //removes past sim_out file, unless carrying on from it
+    if (RESUME == 0)
+    {
+        remove("sim_out");
+    }
+
+    //state, groups and lift states in one region, every group's buffer in another
+    memorySize = sizeof(SimState) + GROUPS * sizeof(Group) + LIFTS * sizeof(LiftState);
+    memory = (char*)backend->share(&memorySize, "Memory");
+    bufferSize = GROUPS * PRIORITY_LEVELS * capacity * sizeof(Request);
+    buffer = (Request*)backend->share(&bufferSize, "Buffer");
+
+    sim = (SimState*)memory;
+    groups = (Group*)(memory + sizeof(SimState));
+    liftStates = (LiftState*)(memory + sizeof(SimState) + GROUPS * sizeof(Group));
+    memcpy(groups, parsed, GROUPS * sizeof(Group));
+    free(parsed);
+
+    sim->capacity = BUFFER_SIZE;
+    adaptInit(&sim->adaptive, BUFFER_SIZE, ADAPT_LOW, ADAPT_HIGH);
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        groups[ii].buffer = buffer + ii * PRIORITY_LEVELS * capacity;
+        queueInit(&groups[ii].queue, BUFFER_SIZE);
+        groups[ii].requests = 0;
+        groups[ii].movements = 0;
+    }
+
+    //publish live statistics
+    if (STATS)
+    {
+        stats = statsCreate(LIFTS, BUFFER_SIZE);
+    }
+    backend->init();
+
+    //put back the lifts and queue from the snapshot
+    if (RESUME)
+    {
+        resume();
+    }
+
+    backend->run();
+
+    //add final information to file
+    writeSummary(sim->totalMovements, sim->totalRequests);
+    if (GROUPS > 1)
+    {
+        writeGroups();
+    }
+    if (PRIORITY)
+    {
+        writeWaits(&sim->waits);
+    }
+    if (ADAPTIVE)
+    {
+        writeAdaptive(&sim->adaptive);
+    }
+
+    //wait for outstanding sim_out writes
+    outputClose();
+
+    //let liftstat know we are done
+    statsFinish(stats);
+
+    //a finished run has nothing to resume
+    if (CHECKPOINT > 0 || RESUME)
+    {
+        remove(CHECKPOINT_PATH);
+    }
+    free(checkpoint);
+
+    backend->finish();
+    statsDestroy(stats);
+    backend->unshare(buffer, bufferSize);
+    backend->unshare(memory, memorySize);
+
+    printf("-------------------------------------------------\n");
+    printf("            File saved to: sim_out\n");
+    printf("-------------------------------------------------\n");
+    printf("\n");
+}
+
+/****************************************
+* NAME: openOutput
+* IMPORT: whether to say which writer
+* EXPORT: none
+* PURPOSE: opens sim_out in the calling
+*          thread or process
+****************************************/
+void openOutput(int announce)
+{
+    OUTPUT = outputOpen("sim_out", OUTPUT, FSYNC, &sim->outputOffset);
+    if (announce)
+    {
+        printf("Writing sim_out with %s%s\n\n", outputName(OUTPUT), FSYNC ? " (fsync at end)" : "");
+    }
+}
+
+/****************************************
+* NAME: lift (consumer)
+* IMPORT: lift number
+* EXPORT: none
+* PURPOSE: performs lift operation
+****************************************/
+void* lift(void* num)
+{
+    Request request;
+    int movement = 0, prev = 0, totalMovement = 0, reqNo = 0, complete = 0, full;
+    Group* group = liftGroup((int)(intptr_t)num);
+    LiftState* state = &liftStates[(int)(intptr_t)num - 1];
+    long idle;
+
+    //zero unless resumed from a snapshot
+    prev = state->prev;
+    reqNo = state->reqNo;
+    totalMovement = state->totalMovement;
+
+    while (complete == 0)
+    {
+        //locked for shared memory (buffer and count)
+        backend->lock();
+
+        //if no items are in this group's buffer
+        if (group->queue.count == 0 && sim->done == 0)
+        {
+            idle = statsNow();
+            while (group->queue.count == 0 && sim->done == 0)
+            {
+                //put lift to sleep
+                backend->waitRequest(group);
+            }
+            adaptConsumer(&sim->adaptive, statsNow() - idle);
+        }
+
+        //LiftR only ever waits on a full buffer
+        full = group->queue.count >= sim->capacity;
+        if (group->queue.count > 0)
+        {
+            //grab request from buffer
+            request = dequeue(group);
+
+            //works out movement for this request
+            movement = abs(prev - request.origin) + abs(request.origin - request.destination);
+
+            //summation of all previous movements
+            totalMovement += movement;
+
+            //for final output
+            sim->totalMovements += movement;
+            sim->totalRequests++;
+            group->movements += movement;
+            group->requests++;
+
+            //increase request number
+            reqNo++;
+
+            //append request information to file
+            writeOutput(request, (int)(intptr_t)num, movement, reqNo, totalMovement, prev);
+            statsServe(stats, (int)(intptr_t)num, request.destination, movement, sim->count);
+
+            //set new previous floor to current destination
+            prev = request.destination;
+
+            //kept where a checkpoint can see it
+            state->prev = prev;
+            state->reqNo = reqNo;
+            state->totalMovement = totalMovement;
+        }
+        if (sim->done == 1 && group->queue.count == 0)
+        {
+            complete = 1;
+
+            //pass the wake on, a backend may only have woken this lift
+            backend->wakeRequest(group);
+        }
+
+        //signals lift-r to read more requests into buffer since no longer full
+        if (full)
+        {
+            backend->wakeSpace();
+        }
+
+        //release lock
+        backend->unlock();
+
+        //simulate time
+        backend->travel();
+    }
+    return NULL;
+}
+
+/****************************************
+* NAME: request (producer)
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: reads requests in from file
+****************************************/
+void* request()
+{
+    FILE* inputfile;
+    int origin, destination, priority, fields;
+    int error = 0;
+    Group* group;
+    long blocked;
+    int read = 0;
+
+    /*opens and reads sim_input as a file*/
+    inputfile = fopen("sim_input", "r");
+
+    /*checks if file eixsts*/
+    if (inputfile != NULL)
+    {
+        printf("Reading and writing requests...\n\n");
+
+        //skip what the snapshot already read
+        if (RESUME)
+        {
+            fseek(inputfile, checkpoint->inputOffset, SEEK_SET);
+        }
+        while (error == 0 && (fields = readRequest(inputfile, &origin, &destination, &priority)) != 0)
+        {
+            //creates new request
+            Request request;
+
+            //priority column is only read when asked for
+            if (PRIORITY == 0)
+            {
+                priority = 0;
+            }
+
+            //stores relevant information in request
+            if (fields < 2)
+            {
+                printf("Error: sim_input lines must be <origin> <destination> [priority]\n");
+                printf("\nEnding prematurely...\n\n");
+                error++;
+            }
+            else if (priority < 0 || priority >= PRIORITY_LEVELS)
+            {
+                printf("Error: priority must be between 0-%d\n", PRIORITY_LEVELS - 1);
+                printf("\nEnding prematurely...\n\n");
+                error++;
+            }
+            else if (origin < 1 || destination < 1 || origin > FLOORS || destination > FLOORS)
+            {
+                printf("Error: origin and destination must be between 1-%d\n", FLOORS);
+                printf("\nEnding prematurely...\n\n");
+                error++;
+            }
+            else
+            {
+                //stores information in a struct
+                request.origin = origin;
+                request.destination = destination;
+                request.priority = priority;
+
+                //pick the group whose zone covers this trip
+                group = route(request);
+
+                //lock enqueue function for count variable
+                backend->lock();
+
+                //if the group's queue is full, put to sleep until avaliable spot
+                if (group->queue.count >= sim->capacity)
+                {
+                    blocked = statsNow();
+                    while (group->queue.count >= sim->capacity && sim->done == 0)
+                    {
+                        backend->waitSpace();
+                    }
+                    adaptProducer(&sim->adaptive, statsNow() - blocked);
+                }
+
+                //a backend gave up on the run (a remote lift was lost)
+                if (sim->done)
+                {
+                    backend->unlock();
+                    printf("\nEnding prematurely...\n\n");
+                    error++;
+                    continue;
+                }
+
+                //queue request struct
+                enqueue(group, request);
+                if (ADAPTIVE)
+                {
+                    resizeBuffers(group);
+                }
+
+                writeBuffer(origin, destination);
+                statsEnqueue(stats, sim->count);
+
+                //signal that a request has been read into the buffer for consumers
+                backend->wakeRequest(group);
+
+                //snapshot under the lock, written out once it is released
+                read++;
+                if (CHECKPOINT > 0 && read % CHECKPOINT == 0)
+                {
+                    takeCheckpoint(ftell(inputfile));
+                }
+
+                //release lock
+                backend->unlock();
+
+                if (CHECKPOINT > 0 && read % CHECKPOINT == 0 && checkpoint != NULL)
+                {
+                    //the snapshot must not get ahead of sim_out on disk
+                    if (FSYNC)
+                    {
+                        outputSync();
+                    }
+                    checkpointWrite(checkpoint, FSYNC);
+                }
+            }
+        }
+
+        /*closes the file*/
+        fclose(inputfile);
+    }
+    else
+    {
+        /*checks if file is not found*/
+        perror("Error");
+    }
+
+    finishRequests();
+
+    return NULL;
+}
+
+/****************************************
+* NAME: finishRequests
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: no more requests are coming,
+*          wakes the lifts so they can
+*          drain their groups and finish
+****************************************/
+void finishRequests()
+{
+    backend->lock();
+    sim->done = 1;
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        backend->wakeRequest(&groups[ii]);
+    }
+    backend->unlock();
+}
+
+/****************************************
+* NAME: enqueue
+* IMPORT: group, request
+* EXPORT: none
+* PURPOSE: adds reqiest to group buffer
+****************************************/
+void enqueue(Group* group, Request request)
+{
+    //stamped so the wait can be measured when it is served
+    request.queued = statsNow();
+    queuePush(&group->queue, group->buffer, request);
+
+    //increase count
+    sim->count++;
+}
+
+/****************************************
+* NAME: dequeue
+* IMPORT: group
+* EXPORT: request (at front of queue)
+* PURPOSE: removes request from group
+****************************************/
+Request dequeue(Group* group)
+{
+    //most urgent first, oldest first within a priority
+    Request request = queuePop(&group->queue, group->buffer);
+
+    waitRecord(&sim->waits, request.priority, statsNow() - request.queued);
+
+    //decrement count
+    sim->count--;
+
+    return request;
+}
+
+/****************************************
+* NAME: resizeBuffers
+* IMPORT: group just enqueued to
+* EXPORT: none
+* PURPOSE: moves every group's buffer to
+*          the capacity the adaptive mode
+*          asks for (lock held)
+****************************************/
+void resizeBuffers(Group* group)
+{
+    int capacity = adaptCheck(&sim->adaptive, group->queue.count, LIFTS);
+
+    //never below what a group is holding
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        capacity = groups[ii].queue.count > capacity ? groups[ii].queue.count : capacity;
+    }
+    if (capacity == sim->capacity)
+    {
+        return;
+    }
+
+    //buffers were mapped at the upper bound, only the rings move
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        queueResize(&groups[ii].queue, groups[ii].buffer, capacity);
+    }
+
+    sim->capacity = capacity;
+    adaptResized(&sim->adaptive, capacity);
+    statsResize(stats, capacity);
+}
+
+/****************************************
+* NAME: takeCheckpoint
+* IMPORT: sim_input offset
+* EXPORT: none
+* PURPOSE: copies the run's state into
+*          the snapshot (lock held, only
+*          a memcpy and the queue walk)
+****************************************/
+void takeCheckpoint(long inputOffset)
+{
+    int *requests, *layout;
+    Request request;
+
+    checkpoint = checkpointReserve(checkpoint, LIFTS, GROUPS, sim->count);
+    if (checkpoint == NULL)
+    {
+        return;
+    }
+    checkpoint->totalMovements = sim->totalMovements;
+    checkpoint->totalRequests = sim->totalRequests;
+    checkpoint->floors = FLOORS;
+    checkpoint->priority = PRIORITY;
+    checkpoint->adaptive = ADAPTIVE;
+    checkpoint->inputOffset = inputOffset;
+    checkpoint->outputOffset = sim->outputOffset;
+    checkpoint->waits = sim->waits;
+    checkpoint->controller = sim->adaptive;
+
+    //the controller's clock restarts on resume, keep how far it got
+    checkpoint->elapsedNs = statsNow() - sim->adaptive.startNs;
+    memcpy(checkpoint->lift, liftStates, LIFTS * sizeof(LiftState));
+
+    layout = checkpointGroups(checkpoint);
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        *layout++ = groups[ii].low;
+        *layout++ = groups[ii].high;
+        *layout++ = groups[ii].lifts;
+    }
+
+    //each group's queue in the order it would be served
+    requests = checkpointRequests(checkpoint);
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        for (int jj = 0; jj < groups[ii].queue.count; jj++)
+        {
+            request = queueAt(&groups[ii].queue, groups[ii].buffer, jj);
+            *requests++ = request.origin;
+            *requests++ = request.destination;
+            *requests++ = request.priority;
+        }
+    }
+}
+
+/****************************************
+* NAME: checkResume
+* IMPORT: none
+* EXPORT: number of errors
+* PURPOSE: loads sim_checkpoint and makes
+*          sure this run can carry it on
+****************************************/
+int checkResume()
+{
+    int error = 0, *requests, *queued, *layout, capacity;
+    struct stat info;
+    Request request;
+
+    checkpoint = checkpointRead();
+    if (checkpoint == NULL)
+    {
+        return 1;
+    }
+    if (checkpoint->lifts != LIFTS)
+    {
+        printf("Error: sim_checkpoint has %d lifts, this run has %d\n", checkpoint->lifts, LIFTS);
+        return 1;
+    }
+    if (checkpoint->floors != FLOORS)
+    {
+        printf("Error: sim_checkpoint has %d floors, this run has %d\n", checkpoint->floors, FLOORS);
+        return 1;
+    }
+    if (checkpoint->priority != PRIORITY)
+    {
+        printf("Error: sim_checkpoint was taken %s --priority\n", checkpoint->priority ? "with" : "without");
+        return 1;
+    }
+    if (checkpoint->adaptive != ADAPTIVE || (ADAPTIVE &&
+        (checkpoint->controller.low != ADAPT_LOW || checkpoint->controller.high != ADAPT_HIGH)))
+    {
+        printf("Error: sim_checkpoint was taken with other --adaptive bounds\n");
+        return 1;
+    }
+
+    //same zones, or the lifts and queued requests land in other groups
+    layout = checkpointGroups(checkpoint);
+    for (int ii = 0; ii < GROUPS && error == 0; ii++)
+    {
+        if (checkpoint->groups != GROUPS || layout[ii * 3] != groups[ii].low ||
+            layout[ii * 3 + 1] != groups[ii].high || layout[ii * 3 + 2] != groups[ii].lifts)
+        {
+            printf("Error: sim_checkpoint was taken with other --group zones\n");
+            error++;
+        }
+    }
+    if (error != 0)
+    {
+        return error;
+    }
+    if (stat("sim_out", &info) != 0 || info.st_size < checkpoint->outputOffset)
+    {
+        printf("Error: sim_out is shorter than sim_checkpoint expects\n");
+        return 1;
+    }
+
+    //every queued request has to fit back in its group, an adaptive
+    //buffer comes back at the size it had
+    capacity = ADAPTIVE ? checkpoint->controller.capacity : BUFFER_SIZE;
+    if (capacity < 1 || capacity > (ADAPTIVE ? ADAPT_HIGH : BUFFER_SIZE))
+    {
+        printf("Error: sim_checkpoint has a buffer size of %d\n", capacity);
+        return 1;
+    }
+    queued = (int*)calloc(GROUPS, sizeof(int));
+    requests = checkpointRequests(checkpoint);
+    for (int ii = 0; ii < checkpoint->queued && error == 0; ii++)
+    {
+        request.origin = requests[ii * 3];
+        request.destination = requests[ii * 3 + 1];
+        request.priority = requests[ii * 3 + 2];
+        if (request.origin < 1 || request.destination < 1 || request.origin > FLOORS ||
+            request.destination > FLOORS || request.priority < 0 || request.priority >= PRIORITY_LEVELS)
+        {
+            printf("Error: sim_checkpoint does not match this building\n");
+            error++;
+        }
+        else if (++queued[route(request) - groups] > capacity)
+        {
+            printf("Error: buffer size too small for the requests in sim_checkpoint\n");
+            error++;
+        }
+    }
+    free(queued);
+    return error;
+}
+
+/****************************************
+* NAME: resume
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: restores totals, lifts and
+*          queues from the snapshot and
+*          cuts sim_out back to match
+****************************************/
+void resume()
+{
+    int* requests = checkpointRequests(checkpoint);
+    Request request;
+    Group* group;
+
+    sim->totalMovements = checkpoint->totalMovements;
+    sim->totalRequests = checkpoint->totalRequests;
+    sim->outputOffset = checkpoint->outputOffset;
+    if (truncate("sim_out", sim->outputOffset) != 0)
+    {
+        perror("Error: cannot truncate sim_out");
+    }
+
+    //wait times and the buffer size carry on where they were
+    sim->waits = checkpoint->waits;
+    if (ADAPTIVE)
+    {
+        sim->capacity = checkpoint->controller.capacity;
+        for (int ii = 0; ii < GROUPS; ii++)
+        {
+            queueResize(&groups[ii].queue, groups[ii].buffer, sim->capacity);
+        }
+        statsResize(stats, sim->capacity);
+        sim->adaptive = checkpoint->controller;
+        sim->adaptive.startNs = statsNow() - checkpoint->elapsedNs;
+        sim->adaptive.windowNs = statsNow();
+        sim->adaptive.producerNs = 0;
+        sim->adaptive.consumerNs = 0;
+    }
+
+    memcpy(liftStates, checkpoint->lift, LIFTS * sizeof(LiftState));
+    statsRewind(stats, checkpoint->elapsedNs);
+    for (int ii = 0; ii < LIFTS; ii++)
+    {
+        group = liftGroup(ii + 1);
+        group->requests += liftStates[ii].reqNo;
+        group->movements += liftStates[ii].totalMovement;
+
+        //liftstat carries on from the snapshot too
+        statsRestore(stats, ii + 1, liftStates[ii].prev, liftStates[ii].reqNo, liftStates[ii].totalMovement);
+    }
+
+    for (int ii = 0; ii < checkpoint->queued; ii++)
+    {
+        request.origin = requests[ii * 3];
+        request.destination = requests[ii * 3 + 1];
+        request.priority = requests[ii * 3 + 2];
+        enqueue(route(request), request);
+        statsEnqueue(stats, sim->count);
+    }
+    printf("Resuming after %d requests, %d queued\n\n", sim->totalRequests, checkpoint->queued);
+}
+
+/****************************************
+* NAME: checkGroups
+* IMPORT: none
+* EXPORT: number of errors
+* PURPOSE: validates zones, numbers the
+*          lifts in each group
+****************************************/
+int checkGroups()
+{
+    int error = 0, covered;
+
+    //default building, every lift serves every floor
+    if (GROUPS == 0)
+    {
+        groups = (Group*)malloc(sizeof(Group));
+        groups[0].low = 1;
+        groups[0].high = FLOORS;
+        groups[0].lifts = 3;
+        GROUPS = 1;
+    }
+
+    LIFTS = 0;
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        if (groups[ii].low < 1 || groups[ii].high > FLOORS || groups[ii].low > groups[ii].high)
+        {
+            printf("Error: group %d must cover floors within 1-%d\n", ii + 1, FLOORS);
+            error++;
+        }
+        if (groups[ii].lifts < 1)
+        {
+            printf("Error: group %d needs at least one lift\n", ii + 1);
+            error++;
+        }
+        groups[ii].firstLift = LIFTS + 1;
+        LIFTS += groups[ii].lifts;
+    }
+
+    //a zone exactly like an earlier one would never be routed to
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        for (int jj = 0; jj < ii; jj++)
+        {
+            if (groups[ii].low == groups[jj].low && groups[ii].high == groups[jj].high)
+            {
+                printf("Error: groups %d and %d cover the same floors, merge their lifts\n", jj + 1, ii + 1);
+                error++;
+            }
+        }
+    }
+
+    //every floor needs a group or some requests could never be served
+    for (int floor = 1; floor <= FLOORS && error == 0; floor++)
+    {
+        covered = 0;
+        for (int ii = 0; ii < GROUPS; ii++)
+        {
+            if (floor >= groups[ii].low && floor <= groups[ii].high)
+            {
+                covered = 1;
+            }
+        }
+        if (covered == 0)
+        {
+            printf("Error: floor %d is not in any group\n", floor);
+            error++;
+        }
+    }
+    return error;
+}
+
+/****************************************
+* NAME: route
+* IMPORT: request
+* EXPORT: group to queue it on
+* PURPOSE: the narrowest zone the whole
+*          trip stays in, so overlapping
+*          zones split the traffic; a trip
+*          no zone holds goes to the zone
+*          of its top floor, whose lifts
+*          run express through the lower
+*          zones
+****************************************/
+Group* route(Request request)
+{
+    int low = request.origin < request.destination ? request.origin : request.destination;
+    int high = request.origin > request.destination ? request.origin : request.destination;
+    Group* group = NULL;
+
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        if (low >= groups[ii].low && high <= groups[ii].high &&
+            (group == NULL || groups[ii].high - groups[ii].low < group->high - group->low))
+        {
+            group = &groups[ii];
+        }
+    }
+    for (int ii = 0; ii < GROUPS && group == NULL; ii++)
+    {
+        if (high >= groups[ii].low && high <= groups[ii].high)
+        {
+            group = &groups[ii];
+        }
+    }
+    return group != NULL ? group : &groups[0];
+}
+
+/****************************************
+* NAME: liftGroup
+* IMPORT: lift number
+* EXPORT: group the lift belongs to
+* PURPOSE: lifts are numbered group by
+*          group
+****************************************/
+Group* liftGroup(int num)
+{
+    Group* group = &groups[0];
+
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        if (num >= groups[ii].firstLift)
+        {
+            group = &groups[ii];
+        }
+    }
+    return group;
+}
+
+/****************************************
+* NAME: writeOutput
+* IMPORT: relevant lift inf
+* EXPORT: none
+* PURPOSE: writes operation to file
+****************************************/
+void writeOutput(Request request, int num, int movement, int reqNo, int totalMovement, int prev)
+{
+    char text[OUTPUT_RECORD_SIZE];
+    int len;
+
+    len = formatOperation(text, num, prev, request.origin, request.destination, movement, reqNo, totalMovement);
+
+    outputAppend(text, len);
+}
+
+/****************************************
+* NAME: writeBuffer
+* IMPORT: origin, destination
+* EXPORT: none
+* PURPOSE: writes request to file
+****************************************/
+void writeBuffer(int origin, int destination)
+{
+    char text[OUTPUT_RECORD_SIZE];
+    int len;
+
+    len = formatRequest(text, origin, destination);
+
+    outputAppend(text, len);
+}
+
+/****************************************
+* NAME: writeSummary
+* IMPORT: totalMovements, totalRequests
+* EXPORT: none
+* PURPOSE: writes end of file summary
+****************************************/
+void writeSummary(int totalMovements, int totalRequests)
+{
+    char text[OUTPUT_RECORD_SIZE];
+    int len;
+
+    len = formatSummary(text, totalMovements, totalRequests);
+
+    outputAppend(text, len);
+}
+
+/****************************************
+* NAME: writeGroups
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: writes per group totals
+****************************************/
+void writeGroups()
+{
+    char text[OUTPUT_RECORD_SIZE];
+    int len;
+
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        len = snprintf(text, sizeof(text), "Group %d (floors %d-%d, %d lifts): %d requests, %d movements\n",
+                       ii + 1, groups[ii].low, groups[ii].high, groups[ii].lifts, groups[ii].requests, groups[ii].movements);
+        outputAppend(text, len);
+    }
+}
+
+/****************************************
+* NAME: writeWaits
+* IMPORT: wait stats
+* EXPORT: none
+* PURPOSE: writes wait time percentiles
+*          for each priority
+****************************************/
+void writeWaits(const WaitStats* waits)
+{
+    char text[OUTPUT_RECORD_SIZE];
+    int len;
+
+    for (int ii = PRIORITY_LEVELS - 1; ii >= 0; ii--)
+    {
+        if (waits->count[ii] > 0)
+        {
+            len = snprintf(text, sizeof(text), "Priority %d: %ld requests, wait mean %.3f ms, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms\n",
+                           ii, waits->count[ii], waits->totalNs[ii] / 1e6 / waits->count[ii], waitPercentile(waits, ii, 50) / 1e6,
+                           waitPercentile(waits, ii, 90) / 1e6, waitPercentile(waits, ii, 99) / 1e6);
+            outputAppend(text, len);
+        }
+    }
+}
+
+/****************************************
+* NAME: writeAdaptive
+* IMPORT: adaptive controller
+* EXPORT: none
+* PURPOSE: writes the buffer capacity
+*          over time and time blocked
+****************************************/
+void writeAdaptive(const Adaptive* adaptive)
+{
+    char text[OUTPUT_RECORD_SIZE];
+    int len;
+
+    for (int ii = 0; ii < adaptive->changes && ii < ADAPT_HISTORY; ii++)
+    {
+        len = snprintf(text, sizeof(text), "Buffer capacity %d from %.3fs\n",
+                       adaptive->historyCapacity[ii], adaptive->historyNs[ii] / 1e9);
+        outputAppend(text, len);
+    }
+    if (adaptive->changes > ADAPT_HISTORY)
+    {
+        len = snprintf(text, sizeof(text), "(%d later capacity changes not listed)\n", adaptive->changes - ADAPT_HISTORY);
+        outputAppend(text, len);
+    }
+    len = snprintf(text, sizeof(text), "LiftR blocked %.3f ms, lifts idle %.3f ms\n",
+                   adaptive->producerTotalNs / 1e6, adaptive->consumerTotalNs / 1e6);
+    outputAppend(text, len);
+}
+
+/****************************************
+* NAME: readRequest
+* IMPORT: input file, origin, destination,
+*         priority
+* EXPORT: fields read, 0 at end of file
+* PURPOSE: reads the next non blank line
+****************************************/
+int readRequest(FILE* input, int* origin, int* destination, int* priority)
+{
+    char line[128];
+    int fields = 0;
+
+    *priority = 0;
+    while (fields == 0 && fgets(line, sizeof(line), input) != NULL)
+    {
+        fields = sscanf(line, "%d %d %d", origin, destination, priority);
+
+        //blank line, keep going
+        if (fields == EOF)
+        {
+            fields = 0;
+        }
+        //garbage, report it as a bad line
+        else if (fields == 0)
+        {
+            fields = 1;
+        }
+    }
+    return fields;
+}
+
+/****************************************
+* NAME: countLines
+* IMPORT: none
+* EXPORT: line count
+* PURPOSE: checks if file is valid
+****************************************/
+int countLines()
+{
+    FILE* input;
+    char ch;
+    int count = 0;
+    input = fopen("sim_input", "r");
+
+    do
+    {
+        ch = fgetc(input);
+        if(ch == '\n')
+        {
+            count++;
+        }
+    }while(!feof(input));
+    fclose(input);
+    return count;
+}
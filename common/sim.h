@@ -0,0 +1,85 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: simulator core shared by the
+*          threads and processes backends
+* LAST MODIFIED: 19.10.26
+****************************************/
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdio.h>
+
+#include "request.h"
+#include "group.h"
+#include "queue.h"
+#include "adaptive.h"
+#include "checkpoint.h"
+#include "livestats.h"
+#include "backend.h"
+
+//everything the lifts and LiftR change, lives in shared memory
+typedef struct
+{
+    int count;
+    int capacity;
+    int done;
+    int totalMovements;
+    int totalRequests;
+    long outputOffset;
+    WaitStats waits;
+    Adaptive adaptive;
+} SimState;
+
+//options
+extern int BUFFER_SIZE;
+extern int TIME;
+extern int FLOORS;
+extern int GROUPS;
+extern int LIFTS;
+extern int OUTPUT;
+extern int FSYNC;
+extern int STATS;
+extern int PRIORITY;
+extern int ADAPTIVE;
+extern int ADAPT_LOW;
+extern int ADAPT_HIGH;
+extern int CHECKPOINT;
+extern int RESUME;
+extern int REPLAY;
+
+//run state
+extern const Backend* backend;
+extern SimState* sim;
+extern Group* groups;
+extern LiftState* liftStates;
+extern LiveStats* stats;
+extern Checkpoint* checkpoint;
+
+int simOption(const char* arg);
+void simUsage();
+int simCheck();
+void simulate();
+void openOutput(int announce);
+void* lift(void* num);
+void* request();
+void enqueue(Group* group, Request request);
+Request dequeue(Group* group);
+void resizeBuffers(Group* group);
+void finishRequests();
+void takeCheckpoint(long inputOffset);
+int checkResume();
+void resume();
+int checkGroups();
+Group* route(Request request);
+Group* liftGroup(int num);
+void writeOutput(Request request, int num, int movement, int reqNo, int totalMovement, int prev);
+void writeBuffer(int origin, int destination);
+void writeSummary(int totalMovements, int totalRequests);
+void writeGroups();
+void writeWaits(const WaitStats* waits);
+void writeAdaptive(const Adaptive* adaptive);
+int readRequest(FILE* input, int* origin, int* destination, int* priority);
+int countLines();
+
+#endif
@@ -0,0 +1,596 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: threads backend, lifts are
+*          pthreads, fibers or remote
+*          lift_worker processes
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#include "sim.h"
+#include "fiber.h"
+#include "remote.h"
+
+//worker threads for the fiber engine, 0 runs each lift as its own thread
+static int FIBERS = 0;
+
+//dispatcher mode, lifts are remote workers on these sockets
+static char* SERVE = NULL;
+static int BATCH = 0;
+static int* remotes = NULL;
+static long* trips = NULL;
+static int tripCount = 0;
+static long serveStart;
+
+//mutex lock and conds, one cond (or fiber queue) per group
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t less = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t* more = NULL;
+static FiberQueue* waiting = NULL;
+
+static int threadsOption(const char* arg);
+static void threadsUsage();
+static int threadsCheck();
+static void* threadsShare(size_t* size, const char* name);
+static void threadsUnshare(void* memory, size_t size);
+static void threadsInit();
+static void threadsLock();
+static void threadsUnlock();
+static void threadsWaitRequest(Group* group);
+static void threadsWakeRequest(Group* group);
+static void threadsWaitSpace();
+static void threadsWakeSpace();
+static void threadsTravel();
+static void threadsRun();
+static void threadsFinish();
+static void liftFiber(int num);
+static void* remoteLift(void* num);
+static int acceptLifts();
+static int compareTrips(const void* a, const void* b);
+static void remoteReport();
+
+const Backend threadsBackend =
+{
+    "threads", "Threads",
+    threadsOption, threadsUsage, threadsCheck,
+    threadsShare, threadsUnshare,
+    threadsInit, threadsLock, threadsUnlock,
+    threadsWaitRequest, threadsWakeRequest, threadsWaitSpace, threadsWakeSpace,
+    threadsTravel, threadsRun, threadsFinish
+};
+
+/****************************************
+* NAME: threadsOption
+* IMPORT: command line argument
+* EXPORT: 1 taken, -1 taken but bad,
+*         0 not a threads option
+* PURPOSE: parses fiber and dispatcher
+*          options
+****************************************/
+static int threadsOption(const char* arg)
+{
+    int taken = 1;
+
+    if (sscanf(arg, "--fibers=%d", &FIBERS) == 1)
+    {
+        if (FIBERS < 1)
+        {
+            printf("Error: fibers needs at least one worker thread\n");
+            taken = -1;
+        }
+    }
+    else if (strncmp(arg, "--serve=", 8) == 0)
+    {
+        SERVE = (char*)arg + 8;
+    }
+    else if (sscanf(arg, "--batch=%d", &BATCH) == 1)
+    {
+        if (BATCH < 1 || BATCH > REMOTE_MAX_INTS / REMOTE_RESULT_INTS)
+        {
+            printf("Error: batch must be between 1-%d\n", REMOTE_MAX_INTS / REMOTE_RESULT_INTS);
+            taken = -1;
+        }
+    }
+    else
+    {
+        taken = 0;
+    }
+    return taken;
+}
+
+/****************************************
+* NAME: threadsUsage
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: lists the threads options
+****************************************/
+static void threadsUsage()
+{
+    printf("    --fibers=<n>              run lifts as fibers on n worker threads\n");
+    printf("    --serve=<address>         dispatch to lift_worker processes over\n");
+    printf("                              unix:<path> or tcp:<host>:<port>\n");
+    printf("    --batch=<n>               requests per batch sent to a worker\n");
+}
+
+/****************************************
+* NAME: threadsCheck
+* IMPORT: none
+* EXPORT: number of errors
+* PURPOSE: rejects option clashes and
+*          connects the remote lifts
+****************************************/
+static int threadsCheck()
+{
+    int error = 0;
+
+    if (SERVE != NULL && FIBERS > 0)
+    {
+        printf("Error: remote lifts cannot run as fibers\n");
+        error++;
+    }
+    if ((CHECKPOINT > 0 || RESUME) && SERVE != NULL)
+    {
+        printf("Error: checkpoints need local lifts\n");
+        error++;
+    }
+
+    //by default a remote lift can take a whole buffer at once
+    if (BATCH == 0)
+    {
+        BATCH = BUFFER_SIZE < REMOTE_MAX_INTS / REMOTE_RESULT_INTS ? BUFFER_SIZE : REMOTE_MAX_INTS / REMOTE_RESULT_INTS;
+    }
+    if (error == 0 && SERVE != NULL)
+    {
+        error = acceptLifts();
+    }
+    return error;
+}
+
+/****************************************
+* NAME: threadsShare
+* IMPORT: size, region name
+* EXPORT: zeroed memory
+* PURPOSE: threads already share the heap
+****************************************/
+static void* threadsShare(size_t* size, const char* name)
+{
+    void* memory = calloc(1, *size);
+
+    if (memory == NULL)
+    {
+        fprintf(stderr, "Error: cannot allocate %s\n", name);
+        exit(1);
+    }
+    return memory;
+}
+
+/****************************************
+* NAME: threadsUnshare
+* IMPORT: memory, size
+* EXPORT: none
+* PURPOSE: frees a shared region
+****************************************/
+static void threadsUnshare(void* memory, size_t size)
+{
+    free(memory);
+}
+
+/****************************************
+* NAME: threadsInit
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: one cond and fiber queue per
+*          group
+****************************************/
+static void threadsInit()
+{
+    more = (pthread_cond_t*)malloc(GROUPS * sizeof(pthread_cond_t));
+    waiting = (FiberQueue*)calloc(GROUPS, sizeof(FiberQueue));
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        pthread_cond_init(&more[ii], NULL);
+    }
+}
+
+/****************************************
+* NAME: threadsLock
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: takes the simulation lock
+****************************************/
+static void threadsLock()
+{
+    pthread_mutex_lock(&lock);
+}
+
+/****************************************
+* NAME: threadsUnlock
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: releases the simulation lock
+****************************************/
+static void threadsUnlock()
+{
+    pthread_mutex_unlock(&lock);
+}
+
+/****************************************
+* NAME: threadsWaitRequest
+* IMPORT: group
+* EXPORT: none
+* PURPOSE: blocks the lift until its
+*          group gets a request (lock
+*          held, released while waiting)
+****************************************/
+static void threadsWaitRequest(Group* group)
+{
+    if (FIBERS > 0)
+    {
+        fiberWait(&waiting[group - groups], &lock);
+    }
+    else
+    {
+        pthread_cond_wait(&more[group - groups], &lock);
+    }
+}
+
+/****************************************
+* NAME: threadsWakeRequest
+* IMPORT: group
+* EXPORT: none
+* PURPOSE: wakes lifts waiting on group
+****************************************/
+static void threadsWakeRequest(Group* group)
+{
+    if (FIBERS > 0)
+    {
+        fiberWake(&waiting[group - groups]);
+    }
+    else
+    {
+        pthread_cond_broadcast(&more[group - groups]);
+    }
+}
+
+/****************************************
+* NAME: threadsWaitSpace
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: blocks LiftR until a lift
+*          takes from a full buffer
+****************************************/
+static void threadsWaitSpace()
+{
+    pthread_cond_wait(&less, &lock);
+}
+
+/****************************************
+* NAME: threadsWakeSpace
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: wakes LiftR
+****************************************/
+static void threadsWakeSpace()
+{
+    pthread_cond_broadcast(&less);
+}
+
+/****************************************
+* NAME: threadsTravel
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: simulates the travel time
+****************************************/
+static void threadsTravel()
+{
+    if (FIBERS > 0)
+    {
+        fiberSleep(TIME);
+    }
+    else
+    {
+        sleep(TIME);
+    }
+}
+
+/****************************************
+* NAME: threadsRun
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: creates LiftR and the lifts
+*          and waits for them
+****************************************/
+static void threadsRun()
+{
+    pthread_t* name = (pthread_t*)malloc((LIFTS + 1) * sizeof(pthread_t));
+
+    //open sim_out with the chosen backend
+    openOutput(1);
+
+    //create threads
+    //liftR
+    printf("Creating threads...\n\n");
+    if (pthread_create(&(name[0]), NULL, request, NULL) != 0)
+    {
+        fprintf(stderr, "Error: cannot create LiftR");
+    }
+    else if (FIBERS > 0)
+    {
+        //lift1-n as fibers, returns once every lift has finished
+        fiberRun(LIFTS, FIBERS, liftFiber);
+    }
+    else
+    {
+        //lift1-n
+        for (int ii = 1; ii <= LIFTS; ii++)
+        {
+            if (pthread_create(&(name[ii]), NULL, SERVE != NULL ? remoteLift : lift, (void*)(intptr_t)ii) != 0)
+            {
+                fprintf(stderr, "Error: cannot create Lift%d\n", ii);
+            }
+        }
+    }
+
+    //waits for threads to finish
+    //liftR
+    if (pthread_join(name[0], NULL) != 0)
+    {
+        fprintf(stderr, "Error: cannot join LiftR\n");
+    }
+    else if (FIBERS == 0)
+    {
+        //lift1-n
+        for (int ii = 1; ii <= LIFTS; ii++)
+        {
+            if (pthread_join(name[ii], NULL) != 0)
+            {
+                fprintf(stderr, "Error: cannot join Lift%d\n", ii);
+            }
+        }
+    }
+    free(name);
+}
+
+/****************************************
+* NAME: threadsFinish
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: fiber and dispatcher reports,
+*          destroys the conds
+****************************************/
+static void threadsFinish()
+{
+    if (FIBERS > 0)
+    {
+        fiberReport();
+    }
+    if (SERVE != NULL)
+    {
+        remoteReport();
+    }
+    for (int ii = 0; ii < GROUPS; ii++)
+    {
+        pthread_cond_destroy(&more[ii]);
+    }
+    free(more);
+    free(waiting);
+}
+
+/****************************************
+* NAME: liftFiber
+* IMPORT: lift number
+* EXPORT: none
+* PURPOSE: fiber entry point for a lift
+****************************************/
+static void liftFiber(int num)
+{
+    lift((void*)(intptr_t)num);
+}
+
+/****************************************
+* NAME: remoteLift (consumer)
+* IMPORT: lift number
+* EXPORT: none
+* PURPOSE: stands in for a remote lift,
+*          sends it batches and writes
+*          out the results it returns
+****************************************/
+static void* remoteLift(void* num)
+{
+    int batch[REMOTE_MAX_INTS], results[REMOTE_MAX_INTS];
+    int welcome[2] = { (int)(intptr_t)num, TIME };
+    int fd = remotes[(int)(intptr_t)num], complete = 0, lost = 0, taken, got, type, full;
+    Group* group = liftGroup((int)(intptr_t)num);
+    Request request;
+    long sent, idle;
+
+    if (remoteSend(fd, REMOTE_WELCOME, welcome, 2) != 0)
+    {
+        fprintf(stderr, "Error: cannot reach Lift-%d\n", (int)(intptr_t)num);
+        complete = 1;
+        lost = 1;
+    }
+
+    while (complete == 0)
+    {
+        pthread_mutex_lock(&lock);
+
+        //if no items are in this group's buffer
+        if (group->queue.count == 0 && sim->done == 0)
+        {
+            idle = statsNow();
+            while (group->queue.count == 0 && sim->done == 0)
+            {
+                pthread_cond_wait(&more[group - groups], &lock);
+            }
+            adaptConsumer(&sim->adaptive, statsNow() - idle);
+        }
+
+        //take up to a batch worth of requests
+        full = group->queue.count >= sim->capacity;
+        taken = 0;
+        while (group->queue.count > 0 && taken < BATCH)
+        {
+            request = dequeue(group);
+            batch[taken * REMOTE_REQUEST_INTS] = request.origin;
+            batch[taken * REMOTE_REQUEST_INTS + 1] = request.destination;
+            taken++;
+        }
+        if (sim->done == 1 && group->queue.count == 0)
+        {
+            complete = 1;
+        }
+        if (full)
+        {
+            pthread_cond_broadcast(&less);
+        }
+        pthread_mutex_unlock(&lock);
+
+        if (taken > 0)
+        {
+            sent = statsNow();
+            if (remoteSend(fd, REMOTE_BATCH, batch, taken * REMOTE_REQUEST_INTS) != 0 ||
+                (got = remoteReceive(fd, &type, results, REMOTE_MAX_INTS)) != taken * REMOTE_RESULT_INTS || type != REMOTE_RESULTS)
+            {
+                fprintf(stderr, "Error: lost Lift-%d, %d requests dropped\n", (int)(intptr_t)num, taken);
+                complete = 1;
+                lost = 1;
+            }
+            else
+            {
+                pthread_mutex_lock(&lock);
+                trips = (long*)realloc(trips, (tripCount + 1) * sizeof(long));
+                trips[tripCount++] = statsNow() - sent;
+
+                for (int ii = 0; ii < taken; ii++)
+                {
+                    int* result = &results[ii * REMOTE_RESULT_INTS];
+
+                    request.origin = result[0];
+                    request.destination = result[1];
+
+                    //for final output
+                    sim->totalMovements += result[3];
+                    sim->totalRequests++;
+                    group->movements += result[3];
+                    group->requests++;
+
+                    //append request information to file
+                    writeOutput(request, (int)(intptr_t)num, result[3], result[4], result[5], result[2]);
+                    statsServe(stats, (int)(intptr_t)num, request.destination, result[3], sim->count);
+                }
+                pthread_mutex_unlock(&lock);
+            }
+        }
+    }
+
+    //its requests can't be served any more, end the run rather than
+    //leave LiftR waiting on a group nobody takes from
+    if (lost)
+    {
+        pthread_mutex_lock(&lock);
+        sim->done = 1;
+        pthread_cond_broadcast(&less);
+        for (int ii = 0; ii < GROUPS; ii++)
+        {
+            pthread_cond_broadcast(&more[ii]);
+        }
+        pthread_mutex_unlock(&lock);
+    }
+
+    //an empty batch tells the worker to finish
+    remoteSend(fd, REMOTE_BATCH, NULL, 0);
+    close(fd);
+
+    return NULL;
+}
+
+/****************************************
+* NAME: acceptLifts
+* IMPORT: none
+* EXPORT: number of errors
+* PURPOSE: waits for a worker connection
+*          for every lift
+****************************************/
+static int acceptLifts()
+{
+    int server = remoteListen(SERVE);
+
+    if (server == -1)
+    {
+        return 1;
+    }
+    printf("Waiting for %d lift workers on %s...\n", LIFTS, SERVE);
+    remotes = (int*)malloc((LIFTS + 1) * sizeof(int));
+    for (int ii = 1; ii <= LIFTS; ii++)
+    {
+        remotes[ii] = accept(server, NULL, NULL);
+        if (remotes[ii] == -1)
+        {
+            perror("Error: cannot accept lift worker");
+            close(server);
+            return 1;
+        }
+        printf("    Lift-%d connected\n", ii);
+    }
+    printf("\n");
+    close(server);
+
+    //nobody else will connect, don't leave the socket file behind
+    if (strncmp(SERVE, "unix:", 5) == 0)
+    {
+        unlink(SERVE + 5);
+    }
+
+    serveStart = statsNow();
+    return 0;
+}
+
+/****************************************
+* NAME: compareTrips
+* IMPORT: two round trip times
+* EXPORT: qsort ordering
+* PURPOSE: sorts round trips ascending
+****************************************/
+static int compareTrips(const void* a, const void* b)
+{
+    long first = *(const long*)a, second = *(const long*)b;
+
+    return (first > second) - (first < second);
+}
+
+/****************************************
+* NAME: remoteReport
+* IMPORT: none
+* EXPORT: none
+* PURPOSE: prints dispatcher throughput
+*          and batch round trip times
+****************************************/
+static void remoteReport()
+{
+    double elapsed = (statsNow() - serveStart) / 1e9, mean = 0;
+
+    printf("Dispatcher: %d remote lifts, %d requests in %d batches over %.3fs (%.0f req/s)\n",
+           LIFTS, sim->totalRequests, tripCount, elapsed, elapsed > 0 ? sim->totalRequests / elapsed : 0);
+    if (tripCount > 0)
+    {
+        qsort(trips, tripCount, sizeof(long), compareTrips);
+        for (int ii = 0; ii < tripCount; ii++)
+        {
+            mean += trips[ii];
+        }
+        mean /= tripCount;
+        printf("    Round trip per batch: mean %.0f us, p50 %.0f us, p99 %.0f us\n",
+               mean / 1e3, trips[tripCount / 2] / 1e3, trips[(tripCount * 99) / 100] / 1e3);
+    }
+    printf("\n");
+    free(trips);
+    free(remotes);
+}
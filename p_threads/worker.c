@@ -0,0 +1,122 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: remote lift worker, pulls batches
+*          from a lift_sim_A dispatcher
+*          (--serve) and streams results back
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "remote.h"
+
+void* remoteWorker(void* address);
+
+int main(int argc, char* argv[])
+{
+    int lifts = 1;
+    pthread_t* name;
+
+    if (argc < 2 || argc > 3 || (argc == 3 && atoi(argv[2]) < 1))
+    {
+        printf("USAGE INFORMATION:\n");
+        printf("Run via ./lift_worker <unix:path | tcp:host:port> [lifts]\n");
+        return 1;
+    }
+    if (argc == 3)
+    {
+        lifts = atoi(argv[2]);
+    }
+
+    //one connection per lift, the dispatcher numbers them
+    name = (pthread_t*)malloc(lifts * sizeof(pthread_t));
+    for (int ii = 0; ii < lifts; ii++)
+    {
+        if (pthread_create(&name[ii], NULL, remoteWorker, argv[1]) != 0)
+        {
+            fprintf(stderr, "Error: cannot create lift %d\n", ii + 1);
+            lifts = ii;
+        }
+    }
+    for (int ii = 0; ii < lifts; ii++)
+    {
+        pthread_join(name[ii], NULL);
+    }
+    free(name);
+
+    return 0;
+}
+
+/****************************************
+* NAME: remoteWorker
+* IMPORT: dispatcher address
+* EXPORT: none
+* PURPOSE: performs lift operation for
+*          every request it is sent
+****************************************/
+void* remoteWorker(void* address)
+{
+    int batch[REMOTE_MAX_INTS], results[REMOTE_MAX_INTS];
+    int fd, type, got, num = 0, time = 0, origin, destination;
+    int movement = 0, prev = 0, totalMovement = 0, reqNo = 0;
+
+    fd = remoteConnect((const char*)address);
+    if (fd == -1)
+    {
+        return NULL;
+    }
+
+    //dispatcher tells us our lift number and the travel time
+    if (remoteReceive(fd, &type, batch, REMOTE_MAX_INTS) == 2 && type == REMOTE_WELCOME)
+    {
+        num = batch[0];
+        time = batch[1];
+    }
+    else
+    {
+        fprintf(stderr, "Error: dispatcher did not assign a lift\n");
+        close(fd);
+        return NULL;
+    }
+
+    //an empty batch means there is no more work
+    while ((got = remoteReceive(fd, &type, batch, REMOTE_MAX_INTS / REMOTE_RESULT_INTS * REMOTE_REQUEST_INTS)) > 0 && type == REMOTE_BATCH)
+    {
+        for (int ii = 0; ii < got / REMOTE_REQUEST_INTS; ii++)
+        {
+            origin = batch[ii * REMOTE_REQUEST_INTS];
+            destination = batch[ii * REMOTE_REQUEST_INTS + 1];
+
+            //works out movement for this request
+            movement = abs(prev - origin) + abs(origin - destination);
+            totalMovement += movement;
+            reqNo++;
+
+            results[ii * REMOTE_RESULT_INTS] = origin;
+            results[ii * REMOTE_RESULT_INTS + 1] = destination;
+            results[ii * REMOTE_RESULT_INTS + 2] = prev;
+            results[ii * REMOTE_RESULT_INTS + 3] = movement;
+            results[ii * REMOTE_RESULT_INTS + 4] = reqNo;
+            results[ii * REMOTE_RESULT_INTS + 5] = totalMovement;
+
+            prev = destination;
+
+            //simulate time
+            sleep(time);
+        }
+        if (remoteSend(fd, REMOTE_RESULTS, results, got / REMOTE_REQUEST_INTS * REMOTE_RESULT_INTS) != 0)
+        {
+            fprintf(stderr, "Error: Lift-%d lost the dispatcher\n", num);
+            break;
+        }
+    }
+    close(fd);
+
+    printf("Lift-%d: %d requests, %d movement\n", num, reqNo, totalMovement);
+
+    return NULL;
+}
@@ -1,18 +0,0 @@
-/****************************************
-* AUTHOR: Andre de Moeller              
-* DATE: 23.03.20                        
-* PURPOSE: memory struct                
-* LAST MODIFIED: 23.03.20               
-****************************************/
-#ifndef MEMORY_H
-#define MEMORY_H
-
-typedef struct 
-{
-    int count;
-    int done;
-    int totalMovements;
-    int totalRequests;
-} Memory;
-
-#endif
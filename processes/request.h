@@ -1,16 +0,0 @@
-/****************************************
-* AUTHOR: Andre de Moeller              
-* DATE: 23.03.20                        
-* PURPOSE: request struct               
-* LAST MODIFIED: 23.03.20               
-****************************************/
-#ifndef REQUEST_H
-#define REQUEST_H
-
-typedef struct 
-{
-  int origin;
-  int destination;
-} Request;
-
-#endif
@@ -0,0 +1,245 @@
+#!/bin/bash
+#****************************************
+# AUTHOR: Andre de Moeller
+# DATE: 19.10.26
+# PURPOSE: runs both backends through every
+#          mode, checks each sim_out, then
+#          times a long replay
+# LAST MODIFIED: 19.10.26
+#****************************************
+# usage: tests/suite.sh [bench_requests]
+#        CC=gcc tests/suite.sh to build with another compiler
+
+root="$(cd "$(dirname "$0")/.." && pwd)"
+requests=${1:-100000}
+passed=0
+failed=0
+
+sim_a="$root/p_threads/lift_sim_A"
+sim_b="$root/processes/lift_sim_B"
+worker="$root/p_threads/lift_worker"
+tracer="$root/tools/lifttrace"
+
+#****************************************
+# NAME: check
+# IMPORT: test name, sim_input
+# EXPORT: none
+# PURPOSE: checks sim_out in the current
+#          directory: every request served
+#          once, each lift carries on from
+#          where it stopped with the next
+#          #Request, and the summary total
+#          matches lifttrace's
+#****************************************
+check()
+{
+    local name="$1" input="$2" want problem traced summary
+
+    want=$(grep -c '[0-9]' "$input")
+    problem=$(awk -v want="$want" '
+        function bad(text) { if (error == "") error = text }
+        /^New lift request from/ { posted++ }
+        /^Lift-[0-9]+ Operation/ { split($1, part, "-"); lift = part[2]; served++ }
+        /^Previous Position: Floor/ {
+            if ($4 != floor[lift] + 0) bad("Lift-" lift " starts at floor " $4 " after ending at " floor[lift] + 0)
+        }
+        /#Request: / {
+            if ($2 != count[lift] + 1) bad("Lift-" lift " #Request " $2 " after " count[lift] + 0)
+            count[lift] = $2
+        }
+        /^Current position:/ { floor[lift] = $3 }
+        /^Total number of requests:/ { total = $5; summaries++ }
+        /^Priority [0-9]+:/ { priority += $3; priorities++ }
+        END {
+            if (posted != want) bad(posted + 0 " requests posted, sim_input has " want)
+            if (served != want) bad(served + 0 " requests served, sim_input has " want)
+            if (summaries != 1 || total != want) bad("summary says " total + 0 " requests, sim_input has " want)
+            if (priorities > 0 && priority != want) bad("priority lines add up to " priority)
+            print error
+        }' sim_out 2>&1)
+
+    # lifttrace works the movement out from the operations alone
+    if [ -z "$problem" ]
+    then
+        traced=$("$tracer" sim_out 1 | awk '/^Total movement:/ { print $3 }')
+        summary=$(awk '/^Total number of movements:/ { print $5 }' sim_out)
+        if [ "$traced" != "$summary" ]
+        then
+            problem="summary movement $summary, lifttrace $traced"
+        fi
+    fi
+
+    if [ -z "$problem" ]
+    then
+        printf "    %-44s ok\n" "$name"
+        passed=$((passed + 1))
+    else
+        printf "    %-44s FAILED: %s\n" "$name" "$problem"
+        failed=$((failed + 1))
+    fi
+}
+
+#****************************************
+# NAME: run
+# IMPORT: test name, sim_input, command
+# EXPORT: none
+# PURPOSE: runs a simulator on a fresh
+#          sim_out and checks it
+#****************************************
+run()
+{
+    local name="$1" input="$2"
+
+    shift 2
+    cp "$input" sim_input
+    rm -f sim_out sim_checkpoint
+    if ! timeout 120 "$@" > run.log 2>&1 || grep -q "^Error" run.log
+    then
+        printf "    %-44s FAILED: %s\n" "$name" "$(grep -m1 "^Error" run.log || echo "exited badly")"
+        failed=$((failed + 1))
+        return
+    fi
+    check "$name" "$input"
+}
+
+#****************************************
+# NAME: crash
+# IMPORT: test name, sim_input, simulator,
+#         options
+# EXPORT: none
+# PURPOSE: kills a checkpointing run part
+#          way through, resumes it and
+#          checks the result is whole
+#****************************************
+crash()
+{
+    local name="$1" input="$2" sim="$3" pid
+
+    shift 3
+    cp "$input" sim_input
+    rm -f sim_out sim_checkpoint
+
+    # its own process group, so the forked lifts die with it
+    setsid "$sim" 3 1 --checkpoint=5 "$@" > run.log 2>&1 &
+    pid=$!
+    sleep 4
+    kill -9 -- -"$pid" 2> /dev/null
+    wait "$pid" 2> /dev/null
+
+    if [ ! -f sim_checkpoint ]
+    then
+        printf "    %-44s FAILED: no sim_checkpoint before the kill\n" "$name"
+        failed=$((failed + 1))
+        return
+    fi
+    if ! timeout 120 "$sim" 3 0 --checkpoint=5 --resume "$@" > run.log 2>&1 || ! grep -q "^Resuming" run.log
+    then
+        printf "    %-44s FAILED: %s\n" "$name" "$(grep -m1 "^Error" run.log || echo "did not resume")"
+        failed=$((failed + 1))
+        return
+    fi
+    check "$name" "$input"
+}
+
+#****************************************
+# NAME: serve
+# IMPORT: test name, sim_input
+# EXPORT: none
+# PURPOSE: runs lift_sim_A as a dispatcher
+#          with three lift_worker lifts
+#****************************************
+serve()
+{
+    local name="$1" input="$2" pid
+
+    cp "$input" sim_input
+    rm -f sim_out sim_checkpoint lifts.sock
+    timeout 120 "$sim_a" 3 0 --serve=unix:"$work"/lifts.sock > run.log 2>&1 &
+    pid=$!
+    for ii in $(seq 50)
+    do
+        [ -S lifts.sock ] && break
+        sleep 0.1
+    done
+    timeout 120 "$worker" unix:"$work"/lifts.sock 3 > worker.log 2>&1
+    if ! wait "$pid" || grep -q "^Error" run.log
+    then
+        printf "    %-44s FAILED: %s\n" "$name" "$(grep -m1 "^Error" run.log || echo "exited badly")"
+        failed=$((failed + 1))
+        return
+    fi
+    check "$name" "$input"
+}
+
+#****************************************
+# NAME: bench
+# IMPORT: label, sim_input, command
+# EXPORT: none
+# PURPOSE: times one replay, reports
+#          requests per second and checks
+#          its sim_out
+#****************************************
+bench()
+{
+    local label="$1" input="$2" start end ms
+
+    shift 2
+    cp "$input" sim_input
+    rm -f sim_out sim_checkpoint
+    start=$(date +%s%N)
+    timeout 600 "$@" > run.log 2>&1
+    end=$(date +%s%N)
+    ms=$(((end - start) / 1000000))
+    printf "    %-44s %6d ms  %8d req/s\n" "$label" "$ms" $((requests * 1000 / (ms > 0 ? ms : 1)))
+    check "$label sim_out" "$input"
+}
+
+echo "Building..."
+for dir in p_threads processes tools
+do
+    if ! make -s -C "$root/$dir" ${CC:+CC=$CC} > /dev/null
+    then
+        echo "Error: $dir does not build"
+        exit 1
+    fi
+done
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+cd "$work"
+
+# the repo's trace, the same with a priority column, and a long replay
+cp "$root/p_threads/sim_input" plain
+awk 'NF >= 2 { print $1, $2, NR % 3 }' plain > priority
+awk -v count="$requests" 'BEGIN { srand(7); for (ii = 0; ii < count; ii++) print int(rand() * 20) + 1, int(rand() * 20) + 1 }' > long
+
+for sim in "$sim_a" "$sim_b"
+do
+    label=$(basename "$sim")
+    echo "$label:"
+    run "default" plain "$sim" 3 0
+    run "--priority" priority "$sim" 3 0 --priority
+    run "--adaptive=2-8" plain "$sim" 3 0 --adaptive=2-8
+    run "--group=1-10:1 --group=11-20:2" plain "$sim" 3 0 --group=1-10:1 --group=11-20:2
+    run "--async" plain "$sim" 3 0 --async
+    run "--async=threads" plain "$sim" 3 0 --async=threads
+    if [ "$sim" = "$sim_a" ]
+    then
+        run "--fibers=2" plain "$sim" 3 0 --fibers=2
+        serve "--serve" plain
+    fi
+    crash "--checkpoint, kill, --resume" plain "$sim"
+    crash "--priority --checkpoint, kill, --resume" priority "$sim" --priority
+    crash "--adaptive --checkpoint, kill, --resume" plain "$sim" --adaptive=2-8
+done
+
+echo "Benchmark, $requests requests, no travel time:"
+bench "lift_sim_A threads" long "$sim_a" 16 0 --replay
+bench "lift_sim_A threads --fibers=2" long "$sim_a" 16 0 --replay --fibers=2
+bench "lift_sim_A threads --async=threads" long "$sim_a" 16 0 --replay --async=threads
+bench "lift_sim_B processes" long "$sim_b" 16 0 --replay
+bench "lift_sim_B processes --async=threads" long "$sim_b" 16 0 --replay --async=threads
+
+echo
+echo "$passed passed, $failed failed"
+[ "$failed" -eq 0 ]
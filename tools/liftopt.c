@@ -0,0 +1,636 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: computes the least total movement
+*          a sim_input trace can be served
+*          with, to judge the online dispatch
+*          in sim_out against
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+
+//lift floors are packed one per byte, sorted, into a state
+#define MAX_LIFTS 8
+#define MAX_FLOOR 254
+#define EMPTY_STATE UINT64_MAX
+
+//frontier sizes past which the exact search gives up / goes parallel
+#define STATE_LIMIT (1 << 22)
+#define PARALLEL_STATES 4096
+
+//least cost seen for each state, open addressing
+typedef struct
+{
+    uint64_t* states;
+    int* costs;
+    long size;
+    long capacity;
+} Table;
+
+//expands one slice of a frontier, then gathers the successors it owns
+typedef struct Worker
+{
+    int id;
+    int workers;
+    const uint64_t* states;
+    const int* costs;
+    long count;
+    int origin;
+    int destination;
+    Table table;
+    Table* outbox;
+    struct Worker* all;
+} Worker;
+
+int LIFTS = 3;
+
+int readTrace(const char* path, int** origins, int** destinations);
+int onlineTotal(const char* path);
+int solveExact(const int* origins, const int* destinations, int count, int threads, long* peak, int* bound);
+int lowerBound(const int* origins, const int* destinations, int start, int count);
+int nearestLift(const int* origins, const int* destinations, int count);
+void* expand(void* arg);
+void* gather(void* arg);
+void tableInit(Table* table, long capacity);
+void tableClear(Table* table);
+void tableInsert(Table* table, uint64_t state, uint64_t hash, int cost);
+uint64_t hashState(uint64_t state);
+
+int main(int argc, char* argv[])
+{
+    int *origins, *destinations;
+    int count, carried = 0, highest = 0, threads, optimal, online, nearest, bound = 0, exact = 1;
+    long peak = 0;
+    const char* output = argc > 3 ? argv[3] : NULL;
+
+    if (argc < 2 || argc > 4 || (argc > 2 && (atoi(argv[2]) < 1 || atoi(argv[2]) > MAX_LIFTS)))
+    {
+        printf("USAGE INFORMATION:\n");
+        printf("Run via ./liftopt <sim_input> [lifts] [sim_out]\n");
+        printf("    lifts defaults to 3, at most %d\n", MAX_LIFTS);
+        return 1;
+    }
+    if (argc > 2)
+    {
+        LIFTS = atoi(argv[2]);
+    }
+
+    count = readTrace(argv[1], &origins, &destinations);
+    if (count < 0)
+    {
+        return 1;
+    }
+
+    //travel with passengers on board is the same for any dispatch
+    for (int ii = 0; ii < count; ii++)
+    {
+        carried += abs(origins[ii] - destinations[ii]);
+        highest = origins[ii] > highest ? origins[ii] : highest;
+        highest = destinations[ii] > highest ? destinations[ii] : highest;
+    }
+
+    threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    threads = threads < 1 ? 1 : threads;
+
+    optimal = solveExact(origins, destinations, count, threads, &peak, &bound);
+    nearest = nearestLift(origins, destinations, count);
+
+    printf("-------------------------------------------------\n");
+    printf("Trace: %s, %d requests, %d lifts, floors 1-%d\n", argv[1], count, LIFTS, highest);
+    printf("Movement with passengers: %d\n", carried);
+    if (optimal >= 0)
+    {
+        printf("Optimal total movement: %d (exact, %ld states at most)\n", optimal + carried, peak);
+    }
+    else
+    {
+        //too many lift positions to search, settle for a bound
+        optimal = bound;
+        exact = 0;
+        printf("Lower bound on total movement: %d (search passed %d states)\n", optimal + carried, STATE_LIMIT);
+    }
+    printf("Nearest lift total movement: %d\n", nearest + carried);
+
+    if (output != NULL)
+    {
+        online = onlineTotal(output);
+        if (online < 0)
+        {
+            printf("Error: no 'Total number of movements' in %s\n", output);
+        }
+        else
+        {
+            printf("Online total movement: %d (%s), %.1f%% above %s\n", online, output,
+                   optimal + carried > 0 ? 100.0 * (online - optimal - carried) / (optimal + carried) : 0.0,
+                   exact ? "optimal" : "bound");
+        }
+    }
+    printf("-------------------------------------------------\n");
+
+    free(origins);
+    free(destinations);
+    return 0;
+}
+
+/****************************************
+* NAME: readTrace
+* IMPORT: sim_input path, arrays to fill
+* EXPORT: request count, -1 on error
+* PURPOSE: reads every request in a trace,
+*          any priority column is ignored
+****************************************/
+int readTrace(const char* path, int** origins, int** destinations)
+{
+    FILE* input;
+    char line[128];
+    int count = 0, capacity = 128, origin, destination, fields;
+
+    input = fopen(path, "r");
+    if (input == NULL)
+    {
+        perror("Error opening sim_input");
+        return -1;
+    }
+
+    *origins = (int*)malloc(capacity * sizeof(int));
+    *destinations = (int*)malloc(capacity * sizeof(int));
+    while (fgets(line, sizeof(line), input) != NULL)
+    {
+        fields = sscanf(line, "%d %d", &origin, &destination);
+        if (fields == EOF)
+        {
+            continue;
+        }
+        if (fields != 2 || origin < 1 || destination < 1 || origin > MAX_FLOOR || destination > MAX_FLOOR)
+        {
+            printf("Error: bad request on line %d of %s\n", count + 1, path);
+            fclose(input);
+            free(*origins);
+            free(*destinations);
+            return -1;
+        }
+
+        if (count == capacity)
+        {
+            capacity *= 2;
+            *origins = (int*)realloc(*origins, capacity * sizeof(int));
+            *destinations = (int*)realloc(*destinations, capacity * sizeof(int));
+        }
+        (*origins)[count] = origin;
+        (*destinations)[count] = destination;
+        count++;
+    }
+    fclose(input);
+    return count;
+}
+
+/****************************************
+* NAME: onlineTotal
+* IMPORT: sim_out path
+* EXPORT: last total movement, -1 if none
+* PURPOSE: reads the online result to
+*          compare against
+****************************************/
+int onlineTotal(const char* path)
+{
+    FILE* input;
+    char line[256];
+    int total = -1, value;
+
+    input = fopen(path, "r");
+    if (input == NULL)
+    {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), input) != NULL)
+    {
+        if (sscanf(line, "Total number of movements: %d", &value) == 1)
+        {
+            total = value;
+        }
+    }
+    fclose(input);
+    return total;
+}
+
+/****************************************
+* NAME: solveExact
+* IMPORT: trace, worker threads, peak size,
+*         bound (set if the search gives up)
+* EXPORT: least empty movement, -1 if the
+*         search grew past STATE_LIMIT
+* PURPOSE: dynamic programming over the
+*          sorted lift floors after each
+*          request, keeping the cheapest way
+*          to reach every state
+****************************************/
+int solveExact(const int* origins, const int* destinations, int count, int threads, long* peak, int* bound)
+{
+    Worker* workers;
+    pthread_t* tids;
+    uint64_t* states;
+    int* costs;
+    long frontier = 1, next, used;
+    int best, result = 0;
+
+    workers = (Worker*)calloc(threads, sizeof(Worker));
+    tids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    for (int ii = 0; ii < threads; ii++)
+    {
+        tableInit(&workers[ii].table, 1024);
+
+        //successors for each other worker, found in this worker's slice
+        workers[ii].outbox = (Table*)malloc(threads * sizeof(Table));
+        for (int jj = 0; jj < threads; jj++)
+        {
+            tableInit(&workers[ii].outbox[jj], 1024);
+        }
+        workers[ii].all = workers;
+    }
+
+    //every lift starts on the ground floor
+    states = (uint64_t*)malloc(sizeof(uint64_t));
+    costs = (int*)malloc(sizeof(int));
+    states[0] = 0;
+    costs[0] = 0;
+    *peak = 1;
+
+    for (int rr = 0; rr < count && result == 0; rr++)
+    {
+        //small frontiers are not worth the thread start up
+        used = frontier < PARALLEL_STATES ? 1 : threads;
+        for (int ii = 0; ii < used; ii++)
+        {
+            workers[ii].id = ii;
+            workers[ii].workers = used;
+            workers[ii].states = states;
+            workers[ii].costs = costs;
+            workers[ii].count = frontier;
+            workers[ii].origin = origins[rr];
+            workers[ii].destination = destinations[rr];
+            tableClear(&workers[ii].table);
+            for (int jj = 0; jj < used; jj++)
+            {
+                if (jj != ii)
+                {
+                    tableClear(&workers[ii].outbox[jj]);
+                }
+            }
+        }
+        for (int ii = 1; ii < used; ii++)
+        {
+            pthread_create(&tids[ii], NULL, expand, &workers[ii]);
+        }
+        expand(&workers[0]);
+        for (int ii = 1; ii < used; ii++)
+        {
+            pthread_join(tids[ii], NULL);
+        }
+
+        //then each worker takes in what the others found for it
+        for (int ii = 1; ii < used; ii++)
+        {
+            pthread_create(&tids[ii], NULL, gather, &workers[ii]);
+        }
+        if (used > 1)
+        {
+            gather(&workers[0]);
+        }
+        for (int ii = 1; ii < used; ii++)
+        {
+            pthread_join(tids[ii], NULL);
+        }
+
+        //each worker owns a disjoint set of states, so just concatenate
+        next = 0;
+        for (int ii = 0; ii < used; ii++)
+        {
+            next += workers[ii].table.size;
+        }
+        free(states);
+        free(costs);
+        if (next > STATE_LIMIT)
+        {
+            //the cheapest way through this request is still exact, only
+            //the requests after it fall back to the bound
+            best = INT_MAX;
+            for (int ii = 0; ii < used; ii++)
+            {
+                Table* table = &workers[ii].table;
+                for (long jj = 0; jj < table->capacity; jj++)
+                {
+                    if (table->states[jj] != EMPTY_STATE && table->costs[jj] < best)
+                    {
+                        best = table->costs[jj];
+                    }
+                }
+            }
+            *bound = best + lowerBound(origins, destinations, rr + 1, count);
+            states = NULL;
+            costs = NULL;
+            result = -1;
+        }
+        else
+        {
+            states = (uint64_t*)malloc(next * sizeof(uint64_t));
+            costs = (int*)malloc(next * sizeof(int));
+            frontier = 0;
+            for (int ii = 0; ii < used; ii++)
+            {
+                Table* table = &workers[ii].table;
+                for (long jj = 0; jj < table->capacity; jj++)
+                {
+                    if (table->states[jj] != EMPTY_STATE)
+                    {
+                        states[frontier] = table->states[jj];
+                        costs[frontier] = table->costs[jj];
+                        frontier++;
+                    }
+                }
+            }
+            *peak = frontier > *peak ? frontier : *peak;
+        }
+    }
+
+    if (result == 0)
+    {
+        best = costs[0];
+        for (long ii = 1; ii < frontier; ii++)
+        {
+            best = costs[ii] < best ? costs[ii] : best;
+        }
+        result = best;
+    }
+
+    for (int ii = 0; ii < threads; ii++)
+    {
+        free(workers[ii].table.states);
+        free(workers[ii].table.costs);
+        for (int jj = 0; jj < threads; jj++)
+        {
+            free(workers[ii].outbox[jj].states);
+            free(workers[ii].outbox[jj].costs);
+        }
+        free(workers[ii].outbox);
+    }
+    free(workers);
+    free(tids);
+    free(states);
+    free(costs);
+    return result;
+}
+
+/****************************************
+* NAME: expand
+* IMPORT: worker
+* EXPORT: none
+* PURPOSE: sends each lift of each state in
+*          this worker's slice of the
+*          frontier to the request, sorting
+*          the successors by owning worker
+****************************************/
+void* expand(void* arg)
+{
+    Worker* worker = (Worker*)arg;
+    int floors[MAX_LIFTS], moved[MAX_LIFTS], owner;
+    uint64_t state, hash;
+    long first = worker->count * worker->id / worker->workers;
+    long last = worker->count * (worker->id + 1) / worker->workers;
+
+    for (long ii = first; ii < last; ii++)
+    {
+        for (int ll = 0; ll < LIFTS; ll++)
+        {
+            floors[ll] = (worker->states[ii] >> (8 * ll)) & 0xff;
+        }
+
+        for (int ll = 0; ll < LIFTS; ll++)
+        {
+            //lifts on the same floor lead to the same state
+            if (ll > 0 && floors[ll] == floors[ll - 1])
+            {
+                continue;
+            }
+
+            //drop lift ll and slot its new floor back in order
+            int kk = 0, placed = 0;
+            for (int jj = 0; jj < LIFTS; jj++)
+            {
+                if (jj == ll)
+                {
+                    continue;
+                }
+                if (!placed && worker->destination <= floors[jj])
+                {
+                    moved[kk++] = worker->destination;
+                    placed = 1;
+                }
+                moved[kk++] = floors[jj];
+            }
+            if (!placed)
+            {
+                moved[kk] = worker->destination;
+            }
+
+            state = 0;
+            for (int jj = 0; jj < LIFTS; jj++)
+            {
+                state |= (uint64_t)moved[jj] << (8 * jj);
+            }
+            hash = hashState(state);
+            owner = (int)((hash >> 40) % worker->workers);
+            tableInsert(owner == worker->id ? &worker->table : &worker->outbox[owner], state, hash,
+                        worker->costs[ii] + abs(floors[ll] - worker->origin));
+        }
+    }
+    return NULL;
+}
+
+/****************************************
+* NAME: gather
+* IMPORT: worker
+* EXPORT: none
+* PURPOSE: merges the successors the other
+*          workers found for this one into
+*          its table, keeping the cheapest
+****************************************/
+void* gather(void* arg)
+{
+    Worker* worker = (Worker*)arg;
+    Table* from;
+
+    for (int ww = 0; ww < worker->workers; ww++)
+    {
+        if (ww == worker->id)
+        {
+            continue;
+        }
+        from = &worker->all[ww].outbox[worker->id];
+        for (long ii = 0; ii < from->capacity; ii++)
+        {
+            if (from->states[ii] != EMPTY_STATE)
+            {
+                tableInsert(&worker->table, from->states[ii], hashState(from->states[ii]), from->costs[ii]);
+            }
+        }
+    }
+    return NULL;
+}
+
+/****************************************
+* NAME: lowerBound
+* IMPORT: trace, first request to bound
+* EXPORT: empty movement no dispatch beats
+*         for the requests from start on
+* PURPOSE: a lift can only be waiting where
+*          some earlier request ended, so each
+*          request costs at least the gap to
+*          the nearest such floor
+****************************************/
+int lowerBound(const int* origins, const int* destinations, int start, int count)
+{
+    char seen[MAX_FLOOR + 1];
+    int total = 0, gap;
+
+    memset(seen, 0, sizeof(seen));
+    seen[0] = 1;
+    for (int ii = 0; ii < start; ii++)
+    {
+        seen[destinations[ii]] = 1;
+    }
+    for (int ii = start; ii < count; ii++)
+    {
+        gap = 0;
+        while (!(origins[ii] - gap >= 0 && seen[origins[ii] - gap]) &&
+               !(origins[ii] + gap <= MAX_FLOOR && seen[origins[ii] + gap]))
+        {
+            gap++;
+        }
+        total += gap;
+        seen[destinations[ii]] = 1;
+    }
+    return total;
+}
+
+/****************************************
+* NAME: nearestLift
+* IMPORT: trace
+* EXPORT: empty movement
+* PURPOSE: the simple online dispatch of
+*          sending the closest lift, as a
+*          reference point
+****************************************/
+int nearestLift(const int* origins, const int* destinations, int count)
+{
+    int floors[MAX_LIFTS] = { 0 };
+    int total = 0, best;
+
+    for (int ii = 0; ii < count; ii++)
+    {
+        best = 0;
+        for (int ll = 1; ll < LIFTS; ll++)
+        {
+            if (abs(floors[ll] - origins[ii]) < abs(floors[best] - origins[ii]))
+            {
+                best = ll;
+            }
+        }
+        total += abs(floors[best] - origins[ii]);
+        floors[best] = destinations[ii];
+    }
+    return total;
+}
+
+/****************************************
+* NAME: tableInit
+* IMPORT: table, capacity (power of two)
+* EXPORT: none
+* PURPOSE: allocates an empty table
+****************************************/
+void tableInit(Table* table, long capacity)
+{
+    table->capacity = capacity;
+    table->states = (uint64_t*)malloc(capacity * sizeof(uint64_t));
+    table->costs = (int*)malloc(capacity * sizeof(int));
+    tableClear(table);
+}
+
+/****************************************
+* NAME: tableClear
+* IMPORT: table
+* EXPORT: none
+* PURPOSE: empties a table, keeping its size
+****************************************/
+void tableClear(Table* table)
+{
+    memset(table->states, 0xff, table->capacity * sizeof(uint64_t));
+    table->size = 0;
+}
+
+/****************************************
+* NAME: tableInsert
+* IMPORT: table, state, its hash, cost
+* EXPORT: none
+* PURPOSE: keeps the cheaper cost for a
+*          state, doubling past half full
+****************************************/
+void tableInsert(Table* table, uint64_t state, uint64_t hash, int cost)
+{
+    long slot;
+
+    if (table->size * 2 >= table->capacity)
+    {
+        Table bigger;
+        tableInit(&bigger, table->capacity * 2);
+        for (long ii = 0; ii < table->capacity; ii++)
+        {
+            if (table->states[ii] != EMPTY_STATE)
+            {
+                tableInsert(&bigger, table->states[ii], hashState(table->states[ii]), table->costs[ii]);
+            }
+        }
+        free(table->states);
+        free(table->costs);
+        *table = bigger;
+    }
+
+    slot = hash & (table->capacity - 1);
+    while (table->states[slot] != EMPTY_STATE && table->states[slot] != state)
+    {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    if (table->states[slot] == EMPTY_STATE)
+    {
+        table->states[slot] = state;
+        table->costs[slot] = cost;
+        table->size++;
+    }
+    else if (cost < table->costs[slot])
+    {
+        table->costs[slot] = cost;
+    }
+}
+
+/****************************************
+* NAME: hashState
+* IMPORT: packed state
+* EXPORT: well mixed hash
+* PURPOSE: splitmix64 finaliser, the low
+*          bits pick a slot and the high
+*          bits the owning worker
+****************************************/
+uint64_t hashState(uint64_t state)
+{
+    state ^= state >> 30;
+    state *= 0xbf58476d1ce4e5b9ULL;
+    state ^= state >> 27;
+    state *= 0x94d049bb133111ebULL;
+    state ^= state >> 31;
+    return state;
+}
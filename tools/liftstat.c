@@ -0,0 +1,86 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: polls the live statistics of a
+*          running lift_sim_A / lift_sim_B
+* LAST MODIFIED: 19.10.26
+****************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "livestats.h"
+
+int main(int argc, char* argv[])
+{
+    LiveStats *stats, *now;
+    int interval = 1000, lastServed = 0, running = 1, lifts;
+    long lastNs;
+    double elapsed, rate;
+
+    if (argc > 2 || (argc == 2 && atoi(argv[1]) < 1))
+    {
+        printf("USAGE INFORMATION:\n");
+        printf("Run via ./liftstat [interval_ms]\n");
+        return 1;
+    }
+    if (argc == 2)
+    {
+        interval = atoi(argv[1]);
+    }
+
+    stats = statsAttach(&lifts);
+    if (stats == NULL)
+    {
+        printf("Error: no simulation is publishing statistics (run it with --stats)\n");
+        return 1;
+    }
+    now = (LiveStats*)malloc(sizeof(LiveStats) + lifts * sizeof(LiftStats));
+
+    //the first rate is measured from here, not from the start of the run
+    lastNs = statsNow();
+    if (statsSnapshot(stats, lifts, now) == 0)
+    {
+        lastServed = now->served;
+        if (now->running)
+        {
+            usleep(interval * 1000);
+        }
+    }
+
+    while (running)
+    {
+        if (statsSnapshot(stats, lifts, now) != 0)
+        {
+            printf("Error: statistics are not settling, simulator may have died\n");
+            break;
+        }
+        running = now->running;
+
+        //throughput since the last poll and since the start
+        elapsed = (statsNow() - lastNs) / 1e9;
+        rate = elapsed > 0 ? (now->served - lastServed) / elapsed : 0;
+        lastNs = statsNow();
+        lastServed = now->served;
+
+        printf("-------------------------------------------------\n");
+        printf("%s after %.1fs\n", running ? "Running" : "Finished", (now->updatedNs - now->startNs) / 1e9);
+        printf("Enqueued: %d  Served: %d  Queue: %d/%d\n", now->enqueued, now->served, now->queueDepth, now->bufferSize);
+        printf("Total #movement: %d  Throughput: %.1f req/s (%.1f overall)\n", now->totalMovements, rate,
+               now->updatedNs > now->startNs ? now->served / ((now->updatedNs - now->startNs) / 1e9) : 0.0);
+        for (int ii = 0; ii < now->lifts; ii++)
+        {
+            printf("    Lift-%d: Floor %d, %d requests, %d movement\n", ii + 1,
+                   now->lift[ii].floor, now->lift[ii].requests, now->lift[ii].movement);
+        }
+        fflush(stdout);
+
+        if (running)
+        {
+            usleep(interval * 1000);
+        }
+    }
+
+    free(now);
+    return 0;
+}
@@ -0,0 +1,844 @@
+/****************************************
+* AUTHOR: Andre de Moeller
+* DATE: 19.10.26
+* PURPOSE: trace analytics, loads a sim_out
+*          dispatch log or a sim_input trace
+*          into arrays and works out
+*          movement, floor heatmaps, trip
+*          lengths and lift utilisation
+* LAST MODIFIED: 19.10.26
+****************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//floors fit a byte, like liftopt
+#define MAX_FLOOR 254
+#define FLOOR_SLOTS 256
+#define MAX_LIFT 65535
+
+//records per kernel block, small enough that the per block distances stay
+//in L1 and their sums can't overflow 32 bits
+#define BLOCK 4096
+
+//smaller inputs are not worth starting threads for
+#define PARALLEL_BYTES (1 << 20)
+#define PARALLEL_RECORDS (1 << 16)
+
+//width of the bars in the report
+#define BAR_WIDTH 40
+
+//one array per field so every kernel streams only the bytes it needs,
+//previous and lift are only known for a dispatch log
+typedef struct
+{
+    uint8_t* origin;
+    uint8_t* destination;
+    uint8_t* previous;
+    uint16_t* lift;
+    long count;
+    long capacity;
+} Trace;
+
+//one thread's share of the text, parsed into its own arrays
+typedef struct
+{
+    const char* start;
+    const char* end;
+    const char* fileEnd;
+    int logged;
+    Trace trace;
+    long malformed;
+    int summary;
+} Loader;
+
+//one thread's share of the records and its partial results, each
+//histogram is striped four ways so neighbouring records that land in
+//the same bucket don't wait on each other's increments
+typedef struct
+{
+    const Trace* trace;
+    long from;
+    long to;
+    int lifts;
+    long empty;
+    long loaded;
+    long calls[4][FLOOR_SLOTS];
+    long drops[4][FLOOR_SLOTS];
+    long trips[4][FLOOR_SLOTS];
+    long approaches[4][FLOOR_SLOTS];
+    long* liftRequests;
+    long* liftEmpty;
+    long* liftLoaded;
+} Slice;
+
+int loadTrace(const char* path, int threads, Trace* trace, int* logged, int* summary);
+void* parseRange(void* arg);
+int parseBlock(const char* at, const char* end, Trace* trace);
+int parseRequest(const char* at, const char* end, Trace* trace);
+const char* nextBlock(const char* at, const char* end);
+const char* readNumber(const char* at, const char* end, int* value);
+void traceInit(Trace* trace, long capacity, int logged);
+void traceGrow(Trace* trace);
+void traceFree(Trace* trace);
+void traceRepeat(Trace* trace, int repeat);
+void* analyse(void* arg);
+void histogram(const uint8_t* restrict values, int count, long (*stripe)[FLOOR_SLOTS]);
+void merge(long (*stripe)[FLOOR_SLOTS], long* total);
+int percentile(const long* histogram, long total, double percent);
+void printDistribution(const char* title, const long* histogram, long total);
+void printBar(long value, long most);
+double now();
+
+int main(int argc, char* argv[])
+{
+    Trace trace;
+    Slice* slices;
+    pthread_t* tids;
+    int threads, repeat = 1, logged, summary, used, lifts = 0, highest = 0;
+    long calls[FLOOR_SLOTS] = {0}, drops[FLOOR_SLOTS] = {0}, trips[FLOOR_SLOTS] = {0}, approaches[FLOOR_SLOTS] = {0};
+    long empty = 0, loaded = 0, most, *liftRequests, *liftEmpty, *liftLoaded, records;
+    double loadStart, loadTime, analyseStart, analyseTime;
+
+    if (argc < 2 || argc > 4 || (argc > 2 && atoi(argv[2]) < 1) || (argc > 3 && atoi(argv[3]) < 1))
+    {
+        printf("USAGE INFORMATION:\n");
+        printf("Run via ./lifttrace <sim_out | sim_input> [threads] [repeat]\n");
+        printf("    threads defaults to one per CPU\n");
+        printf("    repeat analyses the trace that many times over, to time\n");
+        printf("    the kernels on more records than a run writes\n");
+        return 1;
+    }
+    threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    threads = threads < 1 ? 1 : threads;
+    if (argc > 2)
+    {
+        threads = atoi(argv[2]);
+    }
+    if (argc > 3)
+    {
+        repeat = atoi(argv[3]);
+    }
+
+    loadStart = now();
+    if (loadTrace(argv[1], threads, &trace, &logged, &summary) != 0)
+    {
+        return 1;
+    }
+    loadTime = now() - loadStart;
+    records = trace.count;
+    traceRepeat(&trace, repeat);
+
+    //work out the building from the records
+    for (long ii = 0; ii < records; ii++)
+    {
+        highest = trace.origin[ii] > highest ? trace.origin[ii] : highest;
+        highest = trace.destination[ii] > highest ? trace.destination[ii] : highest;
+        if (logged)
+        {
+            lifts = trace.lift[ii] > lifts ? trace.lift[ii] : lifts;
+        }
+    }
+
+    //split the records evenly, each slice keeps its own totals
+    used = trace.count < PARALLEL_RECORDS ? 1 : threads;
+    slices = (Slice*)calloc(used, sizeof(Slice));
+    tids = (pthread_t*)malloc(used * sizeof(pthread_t));
+    analyseStart = now();
+    for (int ii = 0; ii < used; ii++)
+    {
+        slices[ii].trace = &trace;
+        slices[ii].from = trace.count * ii / used;
+        slices[ii].to = trace.count * (ii + 1) / used;
+        slices[ii].lifts = lifts;
+    }
+    for (int ii = 1; ii < used; ii++)
+    {
+        pthread_create(&tids[ii], NULL, analyse, &slices[ii]);
+    }
+    analyse(&slices[0]);
+    for (int ii = 1; ii < used; ii++)
+    {
+        pthread_join(tids[ii], NULL);
+    }
+
+    //reduce the slices into slice 0's lift totals
+    liftRequests = slices[0].liftRequests;
+    liftEmpty = slices[0].liftEmpty;
+    liftLoaded = slices[0].liftLoaded;
+    for (int ii = 0; ii < used; ii++)
+    {
+        empty += slices[ii].empty;
+        loaded += slices[ii].loaded;
+        merge(slices[ii].calls, calls);
+        merge(slices[ii].drops, drops);
+        merge(slices[ii].trips, trips);
+        merge(slices[ii].approaches, approaches);
+        for (int jj = 0; jj <= lifts && ii > 0; jj++)
+        {
+            liftRequests[jj] += slices[ii].liftRequests[jj];
+            liftEmpty[jj] += slices[ii].liftEmpty[jj];
+            liftLoaded[jj] += slices[ii].liftLoaded[jj];
+        }
+    }
+    analyseTime = now() - analyseStart;
+
+    printf("-------------------------------------------------\n");
+    if (logged)
+    {
+        printf("Trace: %s (dispatch log), %ld records, %d lifts, floors 1-%d\n", argv[1], records, lifts, highest);
+    }
+    else
+    {
+        printf("Trace: %s (request trace), %ld records, floors 1-%d\n", argv[1], records, highest);
+    }
+    printf("Loaded in %.3f ms (%.0f records/s), analysed %ld records in %.3f ms (%.0f records/s, %d threads)\n",
+           loadTime * 1e3, loadTime > 0 ? records / loadTime : 0, trace.count, analyseTime * 1e3,
+           analyseTime > 0 ? trace.count / analyseTime : 0, used);
+    if (logged)
+    {
+        printf("Total movement: %ld (empty %ld, with passengers %ld)\n", empty + loaded, empty, loaded);
+        if (summary >= 0 && repeat == 1)
+        {
+            printf("sim_out summary: %d (%s)\n", summary, summary == empty + loaded ? "matches" : "differs");
+        }
+    }
+    else
+    {
+        printf("Movement with passengers: %ld\n", loaded);
+    }
+
+    printDistribution("Trip length", trips, trace.count);
+    if (logged)
+    {
+        printDistribution("Approach length", approaches, trace.count);
+    }
+
+    //busiest floor sets the scale, top floor printed first
+    printf("Floor heatmap (calls / drop-offs):\n");
+    most = 0;
+    for (int ii = 1; ii <= highest; ii++)
+    {
+        most = calls[ii] + drops[ii] > most ? calls[ii] + drops[ii] : most;
+    }
+    for (int ii = highest; ii >= 1; ii--)
+    {
+        printf("    Floor %3d %8ld / %-8ld ", ii, calls[ii], drops[ii]);
+        printBar(calls[ii] + drops[ii], most);
+    }
+
+    if (logged)
+    {
+        printf("Lift utilisation:\n");
+        for (int ii = 1; ii <= lifts; ii++)
+        {
+            if (liftRequests[ii] > 0)
+            {
+                printf("    Lift-%d: %ld requests (%.1f%%), movement %ld (%.1f%%), %.1f%% with passengers\n", ii,
+                       liftRequests[ii], 100.0 * liftRequests[ii] / trace.count, liftEmpty[ii] + liftLoaded[ii],
+                       empty + loaded > 0 ? 100.0 * (liftEmpty[ii] + liftLoaded[ii]) / (empty + loaded) : 0.0,
+                       liftEmpty[ii] + liftLoaded[ii] > 0 ? 100.0 * liftLoaded[ii] / (liftEmpty[ii] + liftLoaded[ii]) : 0.0);
+            }
+        }
+    }
+    printf("-------------------------------------------------\n");
+
+    for (int ii = 0; ii < used; ii++)
+    {
+        free(slices[ii].liftRequests);
+        free(slices[ii].liftEmpty);
+        free(slices[ii].liftLoaded);
+    }
+    free(slices);
+    free(tids);
+    traceFree(&trace);
+    return 0;
+}
+
+/****************************************
+* NAME: loadTrace
+* IMPORT: path, threads, trace to fill,
+*         log flag, sim_out summary
+* EXPORT: 0, 1 on error
+* PURPOSE: maps the file and parses it in
+*          slices cut at record starts,
+*          then joins the slices in order
+****************************************/
+int loadTrace(const char* path, int threads, Trace* trace, int* logged, int* summary)
+{
+    Loader* loaders;
+    pthread_t* tids;
+    struct stat info;
+    const char *file, *end, *cut;
+    long malformed = 0, at = 0;
+    int fd, used;
+
+    fd = open(path, O_RDONLY);
+    if (fd == -1 || fstat(fd, &info) != 0)
+    {
+        perror("Error opening trace");
+        return 1;
+    }
+    if (info.st_size == 0)
+    {
+        printf("Error: %s is empty\n", path);
+        close(fd);
+        return 1;
+    }
+    file = (const char*)mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file == MAP_FAILED)
+    {
+        perror("Error mapping trace");
+        return 1;
+    }
+    madvise((void*)file, info.st_size, MADV_SEQUENTIAL);
+    end = file + info.st_size;
+
+    //lift operations only appear in a dispatch log
+    *logged = memmem(file, info.st_size, " Operation\n", 11) != NULL;
+    *summary = -1;
+
+    //cut the file where records start, a log record is a whole block
+    used = info.st_size < PARALLEL_BYTES ? 1 : threads;
+    loaders = (Loader*)calloc(used, sizeof(Loader));
+    tids = (pthread_t*)malloc(used * sizeof(pthread_t));
+    for (int ii = 0; ii < used; ii++)
+    {
+        cut = file + info.st_size * ii / used;
+        if (*logged)
+        {
+            cut = ii == 0 && strncmp(file, "Lift-", 5) == 0 ? file : nextBlock(cut > file ? cut - 1 : cut, end);
+        }
+        else if (ii > 0)
+        {
+            cut = memchr(cut - 1, '\n', end - cut + 1);
+            cut = cut == NULL ? end : cut + 1;
+        }
+        loaders[ii].start = cut;
+        loaders[ii].fileEnd = end;
+        loaders[ii].logged = *logged;
+        if (ii > 0)
+        {
+            loaders[ii - 1].end = cut;
+        }
+    }
+    loaders[used - 1].end = end;
+
+    for (int ii = 1; ii < used; ii++)
+    {
+        pthread_create(&tids[ii], NULL, parseRange, &loaders[ii]);
+    }
+    parseRange(&loaders[0]);
+    for (int ii = 1; ii < used; ii++)
+    {
+        pthread_join(tids[ii], NULL);
+    }
+
+    //join the slices back in file order
+    for (int ii = 0; ii < used; ii++)
+    {
+        at += loaders[ii].trace.count;
+        malformed += loaders[ii].malformed;
+        *summary = loaders[ii].summary >= 0 ? loaders[ii].summary : *summary;
+    }
+    traceInit(trace, at > 0 ? at : 1, *logged);
+    trace->count = at;
+    at = 0;
+    for (int ii = 0; ii < used; ii++)
+    {
+        memcpy(trace->origin + at, loaders[ii].trace.origin, loaders[ii].trace.count);
+        memcpy(trace->destination + at, loaders[ii].trace.destination, loaders[ii].trace.count);
+        if (*logged)
+        {
+            memcpy(trace->previous + at, loaders[ii].trace.previous, loaders[ii].trace.count);
+            memcpy(trace->lift + at, loaders[ii].trace.lift, loaders[ii].trace.count * sizeof(uint16_t));
+        }
+        at += loaders[ii].trace.count;
+        traceFree(&loaders[ii].trace);
+    }
+    munmap((void*)file, info.st_size);
+    free(loaders);
+    free(tids);
+
+    if (malformed > 0)
+    {
+        printf("Warning: skipped %ld malformed records in %s\n", malformed, path);
+    }
+    if (trace->count == 0)
+    {
+        printf("Error: no records in %s\n", path);
+        traceFree(trace);
+        return 1;
+    }
+    return 0;
+}
+
+/****************************************
+* NAME: parseRange
+* IMPORT: loader
+* EXPORT: none
+* PURPOSE: parses every record starting
+*          in the loader's slice
+****************************************/
+void* parseRange(void* arg)
+{
+    Loader* loader = (Loader*)arg;
+    const char *at = loader->start, *last = NULL, *line;
+    int value;
+
+    traceInit(&loader->trace, (loader->end - loader->start) / (loader->logged ? 200 : 4) + 16, loader->logged);
+    loader->summary = -1;
+    if (loader->logged)
+    {
+        //a block may run past the slice end, the next slice starts after it
+        while (at < loader->end)
+        {
+            loader->malformed += parseBlock(at, loader->fileEnd, &loader->trace) != 0;
+            last = at;
+            at = nextBlock(at + 1, loader->end);
+        }
+
+        //the summary follows the last block in the file
+        if (loader->end == loader->fileEnd && last != NULL)
+        {
+            line = memmem(last, loader->end - last, "Total number of movements: ", 27);
+            if (line != NULL && readNumber(line + 27, loader->end, &value) != NULL)
+            {
+                loader->summary = value;
+            }
+        }
+    }
+    else
+    {
+        while (at < loader->end)
+        {
+            loader->malformed += parseRequest(at, loader->end, &loader->trace) != 0;
+            line = memchr(at, '\n', loader->end - at);
+            at = line == NULL ? loader->end : line + 1;
+        }
+    }
+    return NULL;
+}
+
+//matches a string literal, NULL if it isn't there
+#define MATCH(at, end, literal) \
+    ((at) != NULL && (end) - (at) >= (long)sizeof(literal) - 1 && memcmp((at), (literal), sizeof(literal) - 1) == 0 ? \
+     (at) + sizeof(literal) - 1 : NULL)
+
+/****************************************
+* NAME: parseBlock
+* IMPORT: block start, file end, trace
+* EXPORT: 0, 1 if the block is malformed
+* PURPOSE: reads lift, previous floor and
+*          request from a lift operation
+****************************************/
+int parseBlock(const char* at, const char* end, Trace* trace)
+{
+    int num = 0, previous = 0, origin = 0, destination = 0;
+
+    at = MATCH(at, end, "Lift-");
+    at = at != NULL ? readNumber(at, end, &num) : NULL;
+    at = MATCH(at, end, " Operation\nPrevious Position: Floor ");
+    at = at != NULL ? readNumber(at, end, &previous) : NULL;
+    at = MATCH(at, end, "\nRequest: Floor ");
+    at = at != NULL ? readNumber(at, end, &origin) : NULL;
+    at = MATCH(at, end, " to Floor ");
+    at = at != NULL ? readNumber(at, end, &destination) : NULL;
+    if (at == NULL || num < 1 || num > MAX_LIFT || previous > MAX_FLOOR || origin < 1 || origin > MAX_FLOOR ||
+        destination < 1 || destination > MAX_FLOOR)
+    {
+        return 1;
+    }
+
+    if (trace->count == trace->capacity)
+    {
+        traceGrow(trace);
+    }
+    trace->lift[trace->count] = num;
+    trace->previous[trace->count] = previous;
+    trace->origin[trace->count] = origin;
+    trace->destination[trace->count] = destination;
+    trace->count++;
+    return 0;
+}
+
+/****************************************
+* NAME: parseRequest
+* IMPORT: line start, slice end, trace
+* EXPORT: 0, 1 if the line is malformed
+* PURPOSE: reads <origin> <destination>,
+*          blank lines and any priority
+*          column are skipped
+****************************************/
+int parseRequest(const char* at, const char* end, Trace* trace)
+{
+    int origin = 0, destination = 0;
+
+    while (at < end && (*at == ' ' || *at == '\t' || *at == '\r'))
+    {
+        at++;
+    }
+    if (at == end || *at == '\n')
+    {
+        return 0;
+    }
+    at = readNumber(at, end, &origin);
+    while (at != NULL && at < end && (*at == ' ' || *at == '\t'))
+    {
+        at++;
+    }
+    at = at != NULL ? readNumber(at, end, &destination) : NULL;
+    if (at == NULL || origin < 1 || origin > MAX_FLOOR || destination < 1 || destination > MAX_FLOOR)
+    {
+        return 1;
+    }
+
+    if (trace->count == trace->capacity)
+    {
+        traceGrow(trace);
+    }
+    trace->origin[trace->count] = origin;
+    trace->destination[trace->count] = destination;
+    trace->count++;
+    return 0;
+}
+
+/****************************************
+* NAME: nextBlock
+* IMPORT: search start, search end
+* EXPORT: start of the next lift block,
+*         end if there is none
+* PURPOSE: finds "Lift-" at a line start
+****************************************/
+const char* nextBlock(const char* at, const char* end)
+{
+    const char* found;
+
+    if (at >= end)
+    {
+        return end;
+    }
+    found = memmem(at, end - at, "\nLift-", 6);
+    return found == NULL ? end : found + 1;
+}
+
+/****************************************
+* NAME: readNumber
+* IMPORT: text, end, value
+* EXPORT: just past the digits, NULL if
+*         there are none
+* PURPOSE: reads an unsigned decimal
+****************************************/
+const char* readNumber(const char* at, const char* end, int* value)
+{
+    const char* first = at;
+    int number = 0;
+
+    //nine digits can't overflow an int
+    while (at < end && at - first < 9 && *at >= '0' && *at <= '9')
+    {
+        number = number * 10 + (*at - '0');
+        at++;
+    }
+    if (at == first)
+    {
+        return NULL;
+    }
+    *value = number;
+    return at;
+}
+
+/****************************************
+* NAME: traceInit
+* IMPORT: trace, capacity, log flag
+* EXPORT: none
+* PURPOSE: allocates the field arrays
+****************************************/
+void traceInit(Trace* trace, long capacity, int logged)
+{
+    trace->count = 0;
+    trace->capacity = capacity;
+    trace->origin = (uint8_t*)malloc(capacity);
+    trace->destination = (uint8_t*)malloc(capacity);
+    trace->previous = logged ? (uint8_t*)malloc(capacity) : NULL;
+    trace->lift = logged ? (uint16_t*)malloc(capacity * sizeof(uint16_t)) : NULL;
+    if (trace->origin == NULL || trace->destination == NULL || (logged && (trace->previous == NULL || trace->lift == NULL)))
+    {
+        fprintf(stderr, "Error: cannot allocate %ld records\n", capacity);
+        exit(1);
+    }
+}
+
+/****************************************
+* NAME: traceGrow
+* IMPORT: trace
+* EXPORT: none
+* PURPOSE: doubles the field arrays
+****************************************/
+void traceGrow(Trace* trace)
+{
+    trace->capacity *= 2;
+    trace->origin = (uint8_t*)realloc(trace->origin, trace->capacity);
+    trace->destination = (uint8_t*)realloc(trace->destination, trace->capacity);
+    if (trace->previous != NULL)
+    {
+        trace->previous = (uint8_t*)realloc(trace->previous, trace->capacity);
+        trace->lift = (uint16_t*)realloc(trace->lift, trace->capacity * sizeof(uint16_t));
+    }
+    if (trace->origin == NULL || trace->destination == NULL || (trace->previous != NULL && trace->lift == NULL))
+    {
+        fprintf(stderr, "Error: cannot allocate %ld records\n", trace->capacity);
+        exit(1);
+    }
+}
+
+/****************************************
+* NAME: traceFree
+* IMPORT: trace
+* EXPORT: none
+* PURPOSE: frees the field arrays
+****************************************/
+void traceFree(Trace* trace)
+{
+    free(trace->origin);
+    free(trace->destination);
+    free(trace->previous);
+    free(trace->lift);
+}
+
+/****************************************
+* NAME: traceRepeat
+* IMPORT: trace, times over
+* EXPORT: none
+* PURPOSE: tiles the records so the
+*          kernels can be timed on far
+*          more than one run writes
+****************************************/
+void traceRepeat(Trace* trace, int repeat)
+{
+    long count = trace->count;
+
+    while (trace->capacity < count * repeat)
+    {
+        traceGrow(trace);
+    }
+    for (int ii = 1; ii < repeat; ii++)
+    {
+        memcpy(trace->origin + ii * count, trace->origin, count);
+        memcpy(trace->destination + ii * count, trace->destination, count);
+        if (trace->previous != NULL)
+        {
+            memcpy(trace->previous + ii * count, trace->previous, count);
+            memcpy(trace->lift + ii * count, trace->lift, count * sizeof(uint16_t));
+        }
+    }
+    trace->count = count * repeat;
+}
+
+/****************************************
+* NAME: analyse
+* IMPORT: slice
+* EXPORT: none
+* PURPOSE: one pass over a slice of the
+*          records, a block at a time: the
+*          distances are worked out into
+*          small arrays the compiler can
+*          vectorise, then summed and
+*          histogrammed from L1
+****************************************/
+void* analyse(void* arg)
+{
+    Slice* slice = (Slice*)arg;
+    const Trace* trace = slice->trace;
+    uint8_t carried[BLOCK], approach[BLOCK];
+    const uint8_t *restrict origin, *restrict destination, *restrict previous;
+    uint32_t emptySum, loadedSum;
+    int count;
+
+    slice->liftRequests = (long*)calloc(slice->lifts + 1, sizeof(long));
+    slice->liftEmpty = (long*)calloc(slice->lifts + 1, sizeof(long));
+    slice->liftLoaded = (long*)calloc(slice->lifts + 1, sizeof(long));
+
+    for (long from = slice->from; from < slice->to; from += BLOCK)
+    {
+        count = slice->to - from < BLOCK ? (int)(slice->to - from) : BLOCK;
+        origin = trace->origin + from;
+        destination = trace->destination + from;
+
+        //travel with passengers, |origin - destination|
+        loadedSum = 0;
+        for (int ii = 0; ii < count; ii++)
+        {
+            carried[ii] = origin[ii] > destination[ii] ? origin[ii] - destination[ii] : destination[ii] - origin[ii];
+        }
+        for (int ii = 0; ii < count; ii++)
+        {
+            loadedSum += carried[ii];
+        }
+        slice->loaded += loadedSum;
+
+        histogram(origin, count, slice->calls);
+        histogram(destination, count, slice->drops);
+        histogram(carried, count, slice->trips);
+
+        //empty travel to the caller needs the lift's previous floor
+        if (trace->previous != NULL)
+        {
+            previous = trace->previous + from;
+            emptySum = 0;
+            for (int ii = 0; ii < count; ii++)
+            {
+                approach[ii] = previous[ii] > origin[ii] ? previous[ii] - origin[ii] : origin[ii] - previous[ii];
+            }
+            for (int ii = 0; ii < count; ii++)
+            {
+                emptySum += approach[ii];
+            }
+            slice->empty += emptySum;
+            histogram(approach, count, slice->approaches);
+
+            //per lift totals are a scatter, only this loop stays scalar
+            for (int ii = 0; ii < count; ii++)
+            {
+                int num = trace->lift[from + ii];
+
+                slice->liftRequests[num]++;
+                slice->liftEmpty[num] += approach[ii];
+                slice->liftLoaded[num] += carried[ii];
+            }
+        }
+    }
+    return NULL;
+}
+
+/****************************************
+* NAME: histogram
+* IMPORT: byte values, count, striped
+*         histogram
+* EXPORT: none
+* PURPOSE: counts values four at a time
+*          into separate stripes
+****************************************/
+void histogram(const uint8_t* restrict values, int count, long (*stripe)[FLOOR_SLOTS])
+{
+    int ii = 0;
+
+    for (; ii + 4 <= count; ii += 4)
+    {
+        stripe[0][values[ii]]++;
+        stripe[1][values[ii + 1]]++;
+        stripe[2][values[ii + 2]]++;
+        stripe[3][values[ii + 3]]++;
+    }
+    for (; ii < count; ii++)
+    {
+        stripe[0][values[ii]]++;
+    }
+}
+
+/****************************************
+* NAME: merge
+* IMPORT: striped histogram, total
+* EXPORT: none
+* PURPOSE: adds the stripes into a total
+****************************************/
+void merge(long (*stripe)[FLOOR_SLOTS], long* total)
+{
+    for (int ii = 0; ii < FLOOR_SLOTS; ii++)
+    {
+        total[ii] += stripe[0][ii] + stripe[1][ii] + stripe[2][ii] + stripe[3][ii];
+    }
+}
+
+/****************************************
+* NAME: percentile
+* IMPORT: histogram, total, percent
+* EXPORT: smallest value with at least
+*         percent of the records at or
+*         below it
+* PURPOSE: reads a percentile off a
+*          histogram
+****************************************/
+int percentile(const long* histogram, long total, double percent)
+{
+    long seen = 0;
+
+    for (int ii = 0; ii < FLOOR_SLOTS; ii++)
+    {
+        seen += histogram[ii];
+        if (seen > 0 && seen >= total * percent / 100)
+        {
+            return ii;
+        }
+    }
+    return FLOOR_SLOTS - 1;
+}
+
+/****************************************
+* NAME: printDistribution
+* IMPORT: title, histogram, total
+* EXPORT: none
+* PURPOSE: prints mean, percentiles and
+*          a bar per length in floors
+****************************************/
+void printDistribution(const char* title, const long* histogram, long total)
+{
+    long most = 0, longest = 0;
+    double mean = 0;
+
+    for (int ii = 0; ii < FLOOR_SLOTS; ii++)
+    {
+        mean += (double)ii * histogram[ii];
+        most = histogram[ii] > most ? histogram[ii] : most;
+        longest = histogram[ii] > 0 ? ii : longest;
+    }
+    printf("%s (floors): mean %.2f, p50 %d, p90 %d, p99 %d, max %ld\n", title, total > 0 ? mean / total : 0,
+           percentile(histogram, total, 50), percentile(histogram, total, 90), percentile(histogram, total, 99), longest);
+    for (int ii = 0; ii <= longest; ii++)
+    {
+        printf("    %3d %10ld ", ii, histogram[ii]);
+        printBar(histogram[ii], most);
+    }
+}
+
+/****************************************
+* NAME: printBar
+* IMPORT: value, largest value
+* EXPORT: none
+* PURPOSE: prints a bar scaled to the
+*          largest value
+****************************************/
+void printBar(long value, long most)
+{
+    int width = most > 0 ? (int)((double)value * BAR_WIDTH / most + 0.5) : 0;
+
+    printf("|");
+    for (int ii = 0; ii < width; ii++)
+    {
+        printf("#");
+    }
+    printf("\n");
+}
+
+/****************************************
+* NAME: now
+* IMPORT: none
+* EXPORT: seconds on the monotonic clock
+* PURPOSE: times loading and analysis
+****************************************/
+double now()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}